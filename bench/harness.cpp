@@ -0,0 +1,219 @@
+#include "harness.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <new>
+
+namespace {
+std::atomic<std::uint64_t> g_count{0};
+std::atomic<std::uint64_t> g_bytes{0};
+
+void *allocate(std::size_t const size, std::size_t const alignment) {
+    g_count.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    void *pointer =
+        alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__
+            ? std::aligned_alloc(
+                  alignment, (size + alignment - 1) / alignment * alignment
+              )
+            : std::malloc(size ? size : 1);
+
+    if (!pointer)
+        throw std::bad_alloc{};
+
+    return pointer;
+}
+} // namespace
+
+void *operator new(std::size_t const size) {
+    return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new[](std::size_t const size) {
+    return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new(std::size_t const size, std::align_val_t const alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void *
+operator new[](std::size_t const size, std::align_val_t const alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+mlp::bench::Allocations mlp::bench::allocations() {
+    return {
+        g_count.load(std::memory_order_relaxed),
+        g_bytes.load(std::memory_order_relaxed)
+    };
+}
+
+mlp::bench::Harness::Harness(
+    std::string filter, std::chrono::nanoseconds const budget
+)
+    : filter(std::move(filter)), budget(budget) {}
+
+void mlp::bench::Harness::run(
+    std::string const &name, std::size_t const size,
+    std::function<void()> const &operation
+) {
+    if (!name.contains(this->filter))
+        return;
+
+    using Clock = std::chrono::steady_clock;
+
+    try {
+        operation();
+    } catch (std::exception const &error) {
+        std::fprintf(
+            stderr, "%-32s %8zu skipped: %s\n", name.c_str(), size,
+            error.what()
+        );
+
+        return;
+    }
+
+    std::uint64_t iterations = 1;
+    Clock::duration elapsed{};
+    Allocations before{}, after{};
+
+    while (true) {
+        before = allocations();
+        Clock::time_point const start = Clock::now();
+
+        for (std::uint64_t i = 0; i < iterations; ++i)
+            operation();
+
+        elapsed = Clock::now() - start;
+        after = allocations();
+
+        if (elapsed >= this->budget / 4 || iterations >= 1u << 30)
+            break;
+
+        iterations *= elapsed.count() > 0
+                          ? std::clamp<std::uint64_t>(
+                                this->budget / elapsed + 1, 2, 100
+                            )
+                          : 100;
+    }
+
+    auto const count = static_cast<double>(iterations);
+
+    this->results.push_back(
+        {name, size, iterations,
+         std::chrono::duration<double, std::nano>(elapsed).count() / count,
+         static_cast<double>(after.count - before.count) / count,
+         static_cast<double>(after.bytes - before.bytes) / count}
+    );
+
+    std::fprintf(
+        stderr, "%-32s %8zu %14.1f ns/op %10.1f allocs/op %12.1f B/op\n",
+        name.c_str(), size, this->results.back().nanoseconds,
+        this->results.back().allocations, this->results.back().bytes
+    );
+}
+
+std::vector<mlp::bench::Fit> mlp::bench::Harness::fits() const {
+    std::vector<Fit> fits;
+
+    for (Result const &first : this->results) {
+        if (std::ranges::find(fits, first.name, &Fit::name) != fits.end())
+            continue;
+
+        double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+        double su = 0, suu = 0, suy = 0;
+
+        for (Result const &result : this->results) {
+            if (result.name != first.name || !result.size)
+                continue;
+
+            double const u = static_cast<double>(result.size);
+            double const x = std::log(u);
+            double const y = std::log(result.nanoseconds);
+
+            n += 1;
+            sx += x;
+            sy += y;
+            sxx += x * x;
+            sxy += x * y;
+            su += u;
+            suu += u * u;
+            suy += u * y;
+        }
+
+        double const variance = n * sxx - sx * sx;
+
+        if (n < 3 || variance <= 0)
+            continue;
+
+        fits.push_back(
+            {first.name, static_cast<std::size_t>(n),
+             (n * sxy - sx * sy) / variance,
+             std::exp((n * suy - su * sy) / (n * suu - su * su))}
+        );
+    }
+
+    return fits;
+}
+
+void mlp::bench::Harness::json(std::ostream &os) const {
+    os << "{\"benchmarks\": [" << std::fixed << std::setprecision(3);
+
+    for (std::size_t i = 0; i < this->results.size(); ++i) {
+        Result const &result = this->results[i];
+
+        os << (i ? ",\n" : "\n") << "  {\"name\": \"" << result.name
+           << "\", \"size\": " << result.size
+           << ", \"iterations\": " << result.iterations
+           << ", \"ns_per_op\": " << result.nanoseconds
+           << ", \"allocs_per_op\": " << result.allocations
+           << ", \"bytes_per_op\": " << result.bytes << '}';
+    }
+
+    os << "\n], \"fits\": [";
+
+    auto const fits = this->fits();
+
+    for (std::size_t i = 0; i < fits.size(); ++i)
+        os << (i ? ",\n" : "\n") << "  {\"name\": \"" << fits[i].name
+           << "\", \"points\": " << fits[i].points
+           << ", \"exponent\": " << fits[i].exponent
+           << ", \"factor\": " << fits[i].factor << '}';
+
+    os << "\n]}\n";
+}
@@ -0,0 +1,65 @@
+#ifndef HARNESS_H
+#define HARNESS_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace mlp::bench {
+struct Allocations final {
+    std::uint64_t count;
+    std::uint64_t bytes;
+};
+
+[[nodiscard]] Allocations allocations();
+
+struct Result final {
+    std::string name;
+    std::size_t size;
+    std::uint64_t iterations;
+    double nanoseconds;
+    double allocations;
+    double bytes;
+};
+
+// Growth exponent k of ns/op ~ size^k, fitted by least squares on a log-log
+// scale over every result sharing a name, and factor b of ns/op ~ b^size on
+// a log-linear scale. The factor suits sizes such as nesting depths, where
+// every step multiplies the work.
+struct Fit final {
+    std::string name;
+    std::size_t points;
+    double exponent;
+    double factor;
+};
+
+class Harness final {
+    std::vector<Result> results;
+    std::string filter;
+    std::chrono::nanoseconds budget;
+
+  public:
+    explicit Harness(
+        std::string filter = "",
+        std::chrono::nanoseconds budget = std::chrono::milliseconds{200}
+    );
+
+    void run(
+        std::string const &name, std::size_t size,
+        std::function<void()> const &operation
+    );
+
+    [[nodiscard]] std::vector<Fit> fits() const;
+
+    void json(std::ostream &os) const;
+};
+
+template <typename T> void keep(T const &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+} // namespace mlp::bench
+
+#endif // HARNESS_H
@@ -0,0 +1,339 @@
+#include "harness.h"
+
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/generator.h"
+#include "../include/sink.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+#include "../include/variable.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+using namespace mlp;
+
+namespace {
+std::vector<std::string> const k_corpus{
+    "3x^2",     "sin(x)*y", "ln(x + 1)", "2^x",          "x*y*z",
+    "cos(x)^2", "tan(y)/x", "(x + y)^3", "sinh(2x) - 4", "x/(1 + y^2)"
+};
+
+std::vector<std::string> const k_integrable{
+    "sin(2x)", "3x^2", "cos(x)", "4x", "ln(x)", "sec(x)", "x^5", "2sinh(3x)"
+};
+
+std::vector<std::size_t> const k_sizes{1, 16, 256};
+
+std::vector<std::uint32_t> const k_depths{2, 4, 6};
+
+std::vector<std::string> const k_functions{
+    "sin", "cos", "tan", "sinh", "cosh", "tanh", "atan", "ln"
+};
+
+constexpr std::uint64_t k_seed = 0x6d6c70;
+
+std::vector<std::size_t> const k_sweep{16, 32, 64, 128, 256, 512, 1024, 2048};
+
+std::vector<std::size_t> const k_nesting{1, 2, 3, 4, 5, 6, 7, 8};
+
+std::vector<std::uint32_t> const k_orders{1, 2, 3, 4, 5, 6, 7, 8};
+
+enum class Growth { polynomial, exponential };
+
+struct Expected final {
+    std::string_view name;
+    Growth growth;
+    double bound;
+};
+
+// How fast each sweep may grow before --sweep fails by default: a bound on
+// k in n^k where the size counts children, and on b in b^n where it is a
+// nesting depth or a derivative order. They state the growth the operations
+// should have, not what they measure today: adding, multiplying and copying
+// children should stay near linear, and each level of nesting or order of
+// derivative should add work rather than multiply it. --bound overrides one.
+std::vector<Expected> const k_expected{
+    {"sweep/expression/add", Growth::polynomial, 1.2},
+    {"sweep/expression/copy", Growth::polynomial, 1.2},
+    {"sweep/terms/multiply", Growth::polynomial, 1.2},
+    {"sweep/terms/copy", Growth::polynomial, 1.2},
+    {"sweep/expression/simplified", Growth::polynomial, 1.3},
+    {"sweep/expression/derivative", Growth::polynomial, 1.2},
+    {"sweep/nested/tokenise", Growth::exponential, 1.5},
+    {"sweep/nested/simplified", Growth::exponential, 1.5},
+    {"sweep/nested/evaluate", Growth::exponential, 1.5},
+    {"sweep/derivative/order", Growth::exponential, 1.5}
+};
+
+std::string expression(
+    std::vector<std::string> const &corpus, std::size_t const size
+) {
+    std::string result;
+
+    for (std::size_t i = 0; i < size; ++i) {
+        if (i)
+            result += " + ";
+
+        result += corpus[i % corpus.size()];
+    }
+
+    return result;
+}
+
+std::string nested(std::size_t const depth) {
+    std::string result = "x";
+
+    for (std::size_t i = 0; i < depth; ++i)
+        result = k_functions[i % k_functions.size()] + "(x + " + result + ")";
+
+    return result;
+}
+
+void sweep(bench::Harness &harness) {
+    Variable const x{'x'};
+    std::map<Variable, Token> const values{{x, 0.3}};
+
+    for (std::size_t const size : k_sweep) {
+        std::vector<Token> summands;
+        std::vector<Token> factors;
+
+        for (std::size_t i = 0; i < size; ++i)
+            summands.emplace_back(Term{x, static_cast<Constant>(i + 2)});
+
+        for (std::size_t i = 0; i < size / 2; ++i)
+            factors.emplace_back(
+                Function{"sin", {static_cast<Constant>(i + 1)}}
+            );
+
+        factors.resize(size, x);
+
+        Expression sum;
+        Terms product;
+
+        for (Token const &summand : summands)
+            sum += summand;
+
+        for (Token const &factor : factors)
+            product *= factor;
+
+        harness.run("sweep/expression/add", size, [&summands] {
+            Expression expression;
+
+            for (Token const &summand : summands)
+                expression += summand;
+
+            bench::keep(expression);
+        });
+
+        harness.run("sweep/expression/copy", size, [&sum] {
+            bench::keep(Expression{sum});
+        });
+
+        harness.run("sweep/terms/multiply", size, [&factors] {
+            Terms terms;
+
+            for (Token const &factor : factors)
+                terms *= factor;
+
+            bench::keep(terms);
+        });
+
+        harness.run("sweep/terms/copy", size, [&product] {
+            bench::keep(Terms{product});
+        });
+
+        harness.run("sweep/expression/simplified", size, [&sum] {
+            bench::keep(simplified(sum));
+        });
+
+        harness.run("sweep/expression/derivative", size, [&sum, x] {
+            bench::keep(derivative(sum, x, 1));
+        });
+    }
+
+    for (std::size_t const depth : k_nesting) {
+        std::string const text = nested(depth);
+        Token const token = tokenise(text);
+
+        harness.run("sweep/nested/tokenise", depth, [&text] {
+            bench::keep(tokenise(text));
+        });
+
+        harness.run("sweep/nested/simplified", depth, [&token] {
+            bench::keep(simplified(token));
+        });
+
+        harness.run("sweep/nested/evaluate", depth, [&token, &values] {
+            bench::keep(evaluate(token, values));
+        });
+    }
+
+    Token const token = tokenise("sin(x)*x^2 + ln(x + 1)");
+
+    for (std::uint32_t const order : k_orders)
+        harness.run("sweep/derivative/order", order, [&token, x, order] {
+            bench::keep(derivative(token, x, order));
+        });
+}
+
+int usage(char const *program) {
+    std::cerr << "Usage: " << program
+              << " [--filter <substring>] [--json <file>]"
+                 " [--sweep [--bound <sweep>=<bound>]...]\n";
+
+    return 1;
+}
+} // namespace
+
+int main(int const argc, char const *argv[]) {
+    std::string filter;
+    char const *json = nullptr;
+    bool sweeping = false;
+    std::vector<Expected> expectations = k_expected;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--filter") && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) {
+            json = argv[++i];
+        } else if (!std::strcmp(argv[i], "--sweep")) {
+            sweeping = true;
+        } else if (!std::strcmp(argv[i], "--bound") && i + 1 < argc) {
+            std::string_view const bound = argv[++i];
+            std::size_t const separator = bound.find('=');
+            auto const expected = std::ranges::find(
+                expectations, bound.substr(0, separator), &Expected::name
+            );
+            char *end = nullptr;
+
+            if (separator == std::string_view::npos ||
+                expected == expectations.end())
+                return usage(argv[0]);
+
+            expected->bound = std::strtod(argv[i] + separator + 1, &end);
+
+            if (end == argv[i] + separator + 1 || *end)
+                return usage(argv[0]);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    bench::Harness harness{filter};
+
+    if (sweeping) {
+        sweep(harness);
+
+        int status = 0;
+
+        for (auto const &[name, points, exponent, factor] : harness.fits()) {
+            auto const expected = std::ranges::find(
+                expectations, std::string_view{name}, &Expected::name
+            );
+            bool const exponential = expected != expectations.end() &&
+                                     expected->growth == Growth::exponential;
+            double const growth = exponential ? factor : exponent;
+            bool const exceeded =
+                expected != expectations.end() && growth > expected->bound;
+
+            std::fprintf(
+                stderr,
+                exponential ? "%-32s %8zu points  O(%.2f^n)%s\n"
+                            : "%-32s %8zu points  O(n^%.2f)%s\n",
+                name.c_str(), points, growth,
+                exceeded ? "  exceeds bound" : ""
+            );
+
+            status |= exceeded;
+        }
+
+        if (json) {
+            std::ofstream output{json};
+            harness.json(output);
+        } else {
+            harness.json(std::cout);
+        }
+
+        return status;
+    }
+
+    Variable const x{'x'};
+    std::map<Variable, Token> const values{
+        {x, 0.3}, {Variable{'y'}, 0.7}, {Variable{'z'}, 1.1}
+    };
+
+    for (std::size_t const size : k_sizes) {
+        std::string const text = expression(k_corpus, size);
+        Token const token = tokenise(text);
+        Token const integrable = tokenise(expression(k_integrable, size));
+
+        harness.run("tokenise", size, [&text] {
+            bench::keep(tokenise(text));
+        });
+
+        harness.run("simplified", size, [&token] {
+            bench::keep(simplified(token));
+        });
+
+        harness.run("derivative", size, [&token, x] {
+            bench::keep(derivative(token, x, 1));
+        });
+
+        harness.run("integral", size, [&integrable, x] {
+            bench::keep(integral(integrable, x));
+        });
+
+        harness.run("evaluate", size, [&token, &values] {
+            bench::keep(evaluate(token, values));
+        });
+
+        harness.run("to_string", size, [&token] {
+            bench::keep(to_string(token));
+        });
+    }
+
+    for (std::uint32_t const depth : k_depths) {
+        GeneratorOptions const options{
+            .depth = depth, .functions = k_functions
+        };
+        std::string const text = Generator{k_seed, options}.text();
+        Token const token = Generator{k_seed, options}.token();
+
+        harness.run("generated/tokenise", depth, [&text] {
+            bench::keep(tokenise(text));
+        });
+
+        harness.run("generated/simplified", depth, [&token] {
+            bench::keep(simplified(token));
+        });
+
+        harness.run("generated/evaluate", depth, [&token, &values] {
+            bench::keep(evaluate(token, values));
+        });
+
+        harness.run("generated/to_string", depth, [&token] {
+            bench::keep(to_string(token));
+        });
+    }
+
+    Token const token = tokenise("sin(x)*x^2 + ln(x + 1)");
+
+    for (std::uint32_t order = 1; order <= 10; ++order)
+        harness.run(
+            "derivative/order=" + std::to_string(order), 1,
+            [&token, x, order] { bench::keep(derivative(token, x, order)); }
+        );
+
+    if (json) {
+        std::ofstream output{json};
+        harness.json(output);
+    } else {
+        harness.json(std::cout);
+    }
+}
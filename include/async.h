@@ -0,0 +1,34 @@
+#ifndef ASYNC_H
+#define ASYNC_H
+
+#include "cancellation.h"
+#include "token.h"
+
+#include <cstdint>
+#include <future>
+#include <stop_token>
+
+// Runs the operation on the shared Pool with the definitions and settings of
+// the calling thread's Context as they were at the call, so the context may
+// change or be destroyed while the operation is in flight.
+// Requesting stop on the token makes the operation throw Cancelled at its
+// next node, and overrunning the budget makes it throw BudgetExceeded; either
+// frees the partial result and the worker, and the future then holds the
+// exception. Do not wait on these futures from inside a pool task.
+namespace mlp {
+[[nodiscard]] std::future<Token> simplified_async(
+    Token token, std::stop_token stop = {}, Budget const &budget = {}
+);
+
+[[nodiscard]] std::future<Token> derivative_async(
+    Token token, Variable variable, std::uint32_t order,
+    std::stop_token stop = {}, Budget const &budget = {}
+);
+
+[[nodiscard]] std::future<Token> integral_async(
+    Token token, Variable variable, std::stop_token stop = {},
+    Budget const &budget = {}
+);
+} // namespace mlp
+
+#endif // ASYNC_H
@@ -0,0 +1,84 @@
+#ifndef CANCELLATION_H
+#define CANCELLATION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <stop_token>
+
+namespace mlp {
+class Cancelled final : public std::runtime_error {
+  public:
+    Cancelled();
+};
+
+enum class Resource : std::uint8_t { time, nodes, memory };
+
+class BudgetExceeded final : public std::runtime_error {
+  public:
+    Resource resource;
+    std::uint64_t limit;
+    std::uint64_t used;
+
+    BudgetExceeded(Resource resource, std::uint64_t limit, std::uint64_t used);
+};
+
+// Limits on one call. nodes counts the Tokens the engine adds to an
+// Expression or Terms or allocates for a Term's base and power, and memory
+// the size of those Tokens. Neither sees vector capacity growth, strings,
+// temporaries or frees, so both are an approximate lower bound on what the
+// call allocates rather than a cap on its peak footprint, and they are never
+// decremented. time is measured from when the Scope opens and the earlier
+// of it and deadline applies. A time overrun reports both the limit and the
+// time used in milliseconds since the Scope was opened, rounded up, so a
+// whole number of milliseconds set through time is reported as given.
+struct Budget final {
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::time_point::max();
+    std::chrono::steady_clock::duration time =
+        std::chrono::steady_clock::duration::max();
+    std::uint64_t nodes = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t memory = std::numeric_limits<std::uint64_t>::max();
+};
+
+// simplified, derivative and integral call checkpoint() on every node they
+// visit; it throws Cancelled once stop has been requested on the token of
+// the innermost Scope on this thread, and BudgetExceeded past its deadline.
+// Tokens are charged as they are added. parallel_for hands the State
+// on to its workers, which share the same usage.
+namespace cancellation {
+struct State final {
+    std::stop_token token;
+    Budget budget;
+    std::chrono::steady_clock::time_point start;
+    std::atomic<std::uint64_t> nodes{0};
+    std::atomic<std::uint64_t> memory{0};
+};
+
+class Scope final {
+    std::shared_ptr<State> previous;
+
+  public:
+    explicit Scope(std::stop_token token, Budget const &budget = {});
+
+    explicit Scope(std::shared_ptr<State> state);
+
+    Scope(Scope const &) = delete;
+
+    Scope &operator=(Scope const &) = delete;
+
+    ~Scope();
+};
+
+[[nodiscard]] std::shared_ptr<State> current();
+
+void checkpoint();
+
+void charge(std::uint64_t nodes, std::uint64_t bytes);
+} // namespace cancellation
+} // namespace mlp
+
+#endif // CANCELLATION_H
@@ -0,0 +1,109 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "token.h"
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mlp {
+using Definition = std::function<Token(std::vector<Token> const &)>;
+
+struct Lambda final {
+    std::vector<Variable> parameters;
+    std::shared_ptr<Token const> body;
+};
+
+struct Registry final {
+    std::map<std::string, Definition> functions;
+    std::map<std::string, Lambda> lambdas;
+};
+
+class Context final {
+    // libstdc++ guards atomic shared_ptr with a small spin lock, so a load
+    // is not lock-free; Pin keeps the loads to one per top-level call.
+    std::atomic<std::shared_ptr<Registry const>> registry;
+
+    std::mutex writer;
+
+    std::atomic<std::size_t> threshold{0};
+
+  public:
+    class Scope final {
+        Context *previous;
+        Context const *previous_pinned;
+        std::shared_ptr<Registry const> previous_registry;
+
+      public:
+        // With a registry, snapshot() returns it for the scope's duration,
+        // which lets pool tasks share the snapshot of the call that spawned
+        // them.
+        explicit Scope(
+            Context &context, std::shared_ptr<Registry const> registry = {}
+        );
+
+        Scope(Scope const &) = delete;
+
+        Scope &operator=(Scope const &) = delete;
+
+        ~Scope();
+    };
+
+    // Makes snapshot() on the current context return the registry as it
+    // was when the outermost Pin on the thread began, so a whole call and
+    // everything nested in it sees one set of definitions.
+    class Pin final {
+        bool outermost;
+
+      public:
+        Pin();
+
+        Pin(Pin const &) = delete;
+
+        Pin &operator=(Pin const &) = delete;
+
+        ~Pin();
+    };
+
+    Context();
+
+    // Starts from the given definitions, for work that must not depend on
+    // the lifetime of the context they came from.
+    explicit Context(std::shared_ptr<Registry const> registry);
+
+    Context(Context const &) = delete;
+
+    Context &operator=(Context const &) = delete;
+
+    static Context &global();
+
+    static Context &current();
+
+    [[nodiscard]] std::shared_ptr<Registry const> snapshot() const;
+
+    void define(std::string const &name, Definition definition);
+
+    // Throws if body calls name, directly or through other definitions.
+    void define(
+        std::string const &name, std::vector<Variable> parameters, Token body
+    );
+
+    void undef(std::string const &name);
+
+    [[nodiscard]] bool is_defined(std::string const &name) const;
+
+    // Children of an Expression or Terms are simplified and differentiated
+    // on the shared Pool once there are at least threshold of them; 0 keeps
+    // everything on the calling thread.
+    void parallelise(std::size_t threshold);
+
+    [[nodiscard]] std::size_t parallel_threshold() const;
+};
+} // namespace mlp
+
+#endif // CONTEXT_H
@@ -0,0 +1,64 @@
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+namespace mlp {
+enum class Counter : std::uint32_t {
+    node_allocations,
+    term_copies,
+    terms_copies,
+    expression_copies,
+    simplified_constant,
+    simplified_variable,
+    simplified_function,
+    simplified_term,
+    simplified_terms,
+    simplified_expression,
+    function_tokenise,
+    like_term_scans,
+    like_term_steps,
+    count
+};
+
+using Counters =
+    std::array<std::uint64_t, static_cast<std::size_t>(Counter::count)>;
+
+namespace counters {
+using Block = std::array<
+    std::atomic<std::uint64_t>, static_cast<std::size_t>(Counter::count)>;
+
+inline std::atomic<bool> g_enabled{false};
+
+Block &local();
+
+void enable(bool enabled = true);
+
+[[nodiscard]] bool enabled();
+
+[[nodiscard]] Counters snapshot();
+
+void reset();
+
+[[nodiscard]] std::string_view name(Counter counter);
+} // namespace counters
+
+inline void count(
+    [[maybe_unused]] Counter const counter,
+    [[maybe_unused]] std::uint64_t const amount = 1
+) {
+#ifdef MLP_COUNTERS
+    if (!counters::g_enabled.load(std::memory_order_relaxed))
+        return;
+
+    counters::local()[static_cast<std::size_t>(counter)].fetch_add(
+        amount, std::memory_order_relaxed
+    );
+#endif
+}
+} // namespace mlp
+
+#endif // COUNTERS_H
@@ -25,6 +25,8 @@ class Expression final {
 
     explicit operator std::string() const;
 
+    void write(Sink &sink) const;
+
     [[nodiscard]] Expression operator-() const;
 
     Expression &operator+=(Expression const &rhs);
@@ -79,6 +81,13 @@ class Expression final {
     friend Token pow(Token const &lhs, Expression const &rhs);
 
     [[nodiscard]] bool operator==(Expression const &) const;
+
+    friend class BinaryWriter;
+    friend class BinaryReader;
+    friend class Context;
+    friend class Program;
+    friend struct Statistics;
+    friend class Workspace;
 };
 
 [[nodiscard]] Expression operator+(Expression lhs, Token const &rhs);
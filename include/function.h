@@ -4,6 +4,10 @@
 #include "token.h"
 
 #include <functional>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
 #include <vector>
 
 namespace mlp {
@@ -28,12 +32,21 @@ class Function final {
         std::function<Token(std::vector<Token> const &)> definition
     );
 
+    static void define(
+        std::string const &name, std::vector<Variable> parameters,
+        Token const &body
+    );
+
+    static void define(std::string const &definition);
+
     static void undef(std::string const &name);
 
     static bool is_defined(std::string const &name);
 
     explicit operator std::string() const;
 
+    void write(Sink &sink) const;
+
     friend bool is_dependent_on(Function const &token, Variable variable);
 
     friend bool is_linear_of(Function const &token, Variable variable);
@@ -48,9 +61,50 @@ class Function final {
 
     friend Token integral(Function const &token, Variable variable);
 
+    friend std::optional<Token> inlined(Function const &token);
+
     [[nodiscard]] bool operator==(Function const &) const;
+
+    friend class BinaryWriter;
+    friend class Context;
+    friend class Program;
+    friend struct Statistics;
+    friend class Workspace;
 };
 
+[[nodiscard]] std::optional<Token> inlined(Function const &token);
+
+// Splits a definition of the form "f(x, y) = body" into its name, parameters
+// and parsed body without defining anything.
+[[nodiscard]] std::tuple<std::string, std::vector<Variable>, Token>
+parse_definition(std::string const &definition);
+
+[[nodiscard]] std::optional<std::uint32_t> builtin_id(std::string_view name);
+
+[[nodiscard]] std::span<std::string_view const> builtin_names();
+
+[[nodiscard]] float call_builtin(std::uint32_t id, float value);
+
+[[nodiscard]] Constant call_builtin(std::uint32_t id, Constant value);
+
+[[nodiscard]] long double call_builtin(std::uint32_t id, long double value);
+
+// The float and double batches go through the vectorised kernels, the long
+// double batch one value at a time with <cmath>.
+void call_builtin(
+    std::uint32_t id, std::span<float const> values, std::span<float> results
+);
+
+void call_builtin(
+    std::uint32_t id, std::span<Constant const> values,
+    std::span<Constant> results
+);
+
+void call_builtin(
+    std::uint32_t id, std::span<long double const> values,
+    std::span<long double> results
+);
+
 class FunctionFactory final {
     std::string function;
 
@@ -0,0 +1,45 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include "token.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mlp {
+struct GeneratorOptions final {
+    std::uint32_t depth{4};
+    std::uint32_t breadth{3};
+    std::uint32_t variables{3};
+    std::vector<std::string> functions;
+
+    double leaf{1};
+    double add{2};
+    double mul{2};
+    double div{0.5};
+    double pow{0.5};
+    double call{1};
+};
+
+class Generator final {
+    std::mt19937_64 engine;
+    GeneratorOptions options;
+
+    template <typename Builder>
+    auto generate(Builder &builder, std::uint32_t depth) ->
+        typename Builder::value_type;
+
+    std::uint64_t below(std::uint64_t bound);
+
+  public:
+    explicit Generator(std::uint64_t seed, GeneratorOptions options = {});
+
+    [[nodiscard]] Token token();
+
+    [[nodiscard]] std::string text();
+};
+} // namespace mlp
+
+#endif // GENERATOR_H
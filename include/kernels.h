@@ -0,0 +1,98 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include "token.h"
+
+#include <span>
+
+// Batch versions of the built-in functions. Each kernel writes
+// f(x[i]) to y[i] for every i; x and y may be the same span. The bulk of
+// every batch goes through branch-free polynomial code that the compiler
+// vectorises, cloned for AVX-512, AVX2 and SSE4.2 and picked at load
+// time. Lanes outside a kernel's fast range (|x| >= 1e5 for the circular
+// functions, |x| >= 708 for the hyperbolic ones, zeros, infinities, NaNs
+// and subnormals) are recomputed with <cmath>.
+//
+// Maximum error against glibc, sampled over a few million arguments per
+// function:
+//   atan, acot, ln                                     1 ulp
+//   sin, cos, sec, csc, cosh, sech, asin, acos, asec   2 ulp
+//   tan, sinh, acsc, asinh, acosh, atanh, asech,
+//   acsch, acoth                                       3 ulp
+//   cot, tanh, coth                                    4 ulp
+//   csch                                               5 ulp
+//   abs                                                exact
+//
+// The float overloads run the same code on single-precision polynomials,
+// with twice the lanes per vector. Their fast ranges are |x| < 256 for the
+// circular functions and |x| < 86 for the hyperbolic ones. Maximum error
+// against the double-precision result, measuring asec, acsc, acot, asech,
+// acsch and acoth from the float 1 / x they start with:
+//   ln                                                 1 ulp
+//   sin, cos, cosh                                     2 ulp
+//   sec, csc, sinh, atan, acot, sech, asinh, acosh,
+//   asech, acsch, acoth                                3 ulp
+//   tan, cot, tanh, csch, asin, acos, asec, acsc,
+//   atanh                                              4 ulp
+//   coth                                               5 ulp
+//   abs                                                exact
+namespace mlp::kernels {
+void sin(std::span<Constant const> x, std::span<Constant> y);
+void sin(std::span<float const> x, std::span<float> y);
+void cos(std::span<Constant const> x, std::span<Constant> y);
+void cos(std::span<float const> x, std::span<float> y);
+void tan(std::span<Constant const> x, std::span<Constant> y);
+void tan(std::span<float const> x, std::span<float> y);
+void sec(std::span<Constant const> x, std::span<Constant> y);
+void sec(std::span<float const> x, std::span<float> y);
+void csc(std::span<Constant const> x, std::span<Constant> y);
+void csc(std::span<float const> x, std::span<float> y);
+void cot(std::span<Constant const> x, std::span<Constant> y);
+void cot(std::span<float const> x, std::span<float> y);
+
+void sinh(std::span<Constant const> x, std::span<Constant> y);
+void sinh(std::span<float const> x, std::span<float> y);
+void cosh(std::span<Constant const> x, std::span<Constant> y);
+void cosh(std::span<float const> x, std::span<float> y);
+void tanh(std::span<Constant const> x, std::span<Constant> y);
+void tanh(std::span<float const> x, std::span<float> y);
+void sech(std::span<Constant const> x, std::span<Constant> y);
+void sech(std::span<float const> x, std::span<float> y);
+void csch(std::span<Constant const> x, std::span<Constant> y);
+void csch(std::span<float const> x, std::span<float> y);
+void coth(std::span<Constant const> x, std::span<Constant> y);
+void coth(std::span<float const> x, std::span<float> y);
+
+void asin(std::span<Constant const> x, std::span<Constant> y);
+void asin(std::span<float const> x, std::span<float> y);
+void acos(std::span<Constant const> x, std::span<Constant> y);
+void acos(std::span<float const> x, std::span<float> y);
+void atan(std::span<Constant const> x, std::span<Constant> y);
+void atan(std::span<float const> x, std::span<float> y);
+void asec(std::span<Constant const> x, std::span<Constant> y);
+void asec(std::span<float const> x, std::span<float> y);
+void acsc(std::span<Constant const> x, std::span<Constant> y);
+void acsc(std::span<float const> x, std::span<float> y);
+void acot(std::span<Constant const> x, std::span<Constant> y);
+void acot(std::span<float const> x, std::span<float> y);
+
+void asinh(std::span<Constant const> x, std::span<Constant> y);
+void asinh(std::span<float const> x, std::span<float> y);
+void acosh(std::span<Constant const> x, std::span<Constant> y);
+void acosh(std::span<float const> x, std::span<float> y);
+void atanh(std::span<Constant const> x, std::span<Constant> y);
+void atanh(std::span<float const> x, std::span<float> y);
+void asech(std::span<Constant const> x, std::span<Constant> y);
+void asech(std::span<float const> x, std::span<float> y);
+void acsch(std::span<Constant const> x, std::span<Constant> y);
+void acsch(std::span<float const> x, std::span<float> y);
+void acoth(std::span<Constant const> x, std::span<Constant> y);
+void acoth(std::span<float const> x, std::span<float> y);
+
+void ln(std::span<Constant const> x, std::span<Constant> y);
+void ln(std::span<float const> x, std::span<float> y);
+void abs(std::span<Constant const> x, std::span<Constant> y);
+void abs(std::span<float const> x, std::span<float> y);
+} // namespace mlp::kernels
+
+#endif // KERNELS_H
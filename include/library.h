@@ -0,0 +1,70 @@
+#ifndef LIBRARY_H
+#define LIBRARY_H
+
+#include "program.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace mlp {
+class Library final {
+    struct Entry;
+
+    std::byte const *data{nullptr};
+    std::size_t size{0};
+
+    Entry const *entries{nullptr};
+    std::size_t count{0};
+
+    // Programs are verified on their first lookup rather than when the
+    // library is opened, so opening it only touches the header and the entry
+    // table. Each entry's result is kept here: 0 until it is verified, then
+    // 1 if the program is well formed and 2 if it is not.
+    std::unique_ptr<std::atomic<std::uint8_t>[]> verified;
+
+    [[nodiscard]] Entry const *find(std::string_view name) const;
+
+    [[nodiscard]] std::span<std::byte const>
+    region(std::uint64_t offset, std::uint64_t size) const;
+
+    [[nodiscard]] ProgramView view(Entry const &entry) const;
+
+  public:
+    static constexpr std::uint32_t version = 2;
+
+    explicit Library(std::filesystem::path const &path);
+
+    Library(Library const &) = delete;
+
+    Library(Library &&library) noexcept;
+
+    Library &operator=(Library const &) = delete;
+
+    Library &operator=(Library &&library) noexcept;
+
+    ~Library();
+
+    static void write(
+        std::filesystem::path const &path,
+        std::map<std::string, Token> const &expressions
+    );
+
+    [[nodiscard]] std::size_t entry_count() const;
+
+    [[nodiscard]] bool contains(std::string_view name) const;
+
+    [[nodiscard]] Token token(std::string_view name) const;
+
+    [[nodiscard]] std::optional<ProgramView> program(std::string_view name
+    ) const;
+};
+} // namespace mlp
+
+#endif // LIBRARY_H
@@ -0,0 +1,76 @@
+#ifndef MINIMISE_H
+#define MINIMISE_H
+
+#include "program.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mlp {
+enum class Descent : std::uint8_t {
+    lbfgs, // limited-memory quasi-Newton, gradients only
+    newton // exact Hessian, damped until positive definite
+};
+
+enum class MinimumStatus : std::uint8_t {
+    converged, // the gradient's largest component fell below the tolerance
+    stalled,   // the line search found no decrease
+    exhausted  // ran out of iterations
+};
+
+struct MinimiseOptions final {
+    Constant tolerance = 1e-8;
+    std::uint32_t iterations = 200;
+    // Correction pairs kept by L-BFGS.
+    std::uint32_t memory = 8;
+};
+
+struct Minimum final {
+    std::vector<Constant> point;
+    Constant value;
+    std::uint32_t iterations;
+    MinimumStatus status;
+};
+
+// Minimises an objective over some of its variables. The gradient, and for
+// Newton's method the Hessian, are differentiated symbolically and compiled
+// once on construction; minimise() only runs the compiled programs.
+class Minimiser final {
+    Descent descent;
+    std::size_t count;
+    std::string names;
+
+    // The objective, then the gradient, then the Hessian's upper triangle
+    // row by row.
+    std::vector<Program> programs;
+    // For every program, the index of each of its inputs in the point
+    // followed by the parameters.
+    std::vector<std::vector<std::uint32_t>> slots;
+
+    [[nodiscard]] Constant run(
+        std::size_t index, std::span<Constant const> values,
+        std::vector<Column> &columns, std::vector<Constant> &scratch
+    ) const;
+
+  public:
+    Minimiser(
+        Token const &objective, std::vector<Variable> const &variables,
+        Descent descent = Descent::lbfgs
+    );
+
+    // The other variables of the objective, in the order minimise() takes
+    // their values.
+    [[nodiscard]] std::string_view parameters() const;
+
+    [[nodiscard]] Minimum minimise(
+        std::span<Constant const> start,
+        std::span<Constant const> parameters = {},
+        MinimiseOptions const &options = {}
+    ) const;
+};
+} // namespace mlp
+
+#endif // MINIMISE_H
@@ -0,0 +1,74 @@
+#ifndef ODE_H
+#define ODE_H
+
+#include "program.h"
+#include "variable.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mlp {
+enum class OdeScheme : std::uint8_t {
+    rk45,      // explicit Dormand-Prince 5(4)
+    rosenbrock // linearly implicit, second order, for stiff systems
+};
+
+enum class OdeStatus : std::uint8_t {
+    finished,
+    stalled,  // the step size fell below the resolution of t
+    exhausted // ran out of steps; the state holds the last accepted one
+};
+
+struct OdeOptions final {
+    // Every component's error is kept below absolute + tolerance * |y|.
+    Constant tolerance = 1e-6;
+    Constant absolute = 1e-9;
+    // The first step, or 0 to estimate one from the initial slope.
+    Constant step = 0;
+    // Attempted steps per row, accepted or rejected.
+    std::uint32_t steps = 100000;
+};
+
+// Integrates y' = f(t, y, parameters) for many initial conditions at once.
+// The components of f are compiled into one program that computes their
+// common subexpressions once; the Rosenbrock scheme also compiles the
+// symbolic Jacobian the same way. Rows advance together with a step size of
+// their own, in the blocks of parallel_blocks.
+class OdeSolver final {
+    OdeScheme scheme;
+    std::size_t count;
+    std::string names;
+
+    // The right-hand side, then for the Rosenbrock scheme its Jacobian row
+    // by row followed by its derivative in t.
+    std::vector<Program> programs;
+    // For every program, the source of each of its inputs: 0 for t, 1 + j
+    // for state j and 1 + count + k for parameter k.
+    std::vector<std::vector<std::uint32_t>> slots;
+
+  public:
+    OdeSolver(
+        std::vector<Token> const &rhs, std::vector<Variable> const &states,
+        Variable time, OdeScheme scheme = OdeScheme::rk45
+    );
+
+    // The variables other than t and the states, in the order of the
+    // parameter columns.
+    [[nodiscard]] std::string_view parameters() const;
+
+    // states holds one column of rows initial values for every state and
+    // is overwritten with the values at end; status holds one entry per
+    // row and parameters one column of rows values for each of
+    // parameters(), in order.
+    void integrate(
+        Constant start, Constant end, std::span<Constant> states,
+        std::span<Constant const> parameters, std::span<OdeStatus> status,
+        OdeOptions const &options = {}
+    ) const;
+};
+} // namespace mlp
+
+#endif // ODE_H
@@ -0,0 +1,124 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mlp {
+// Work-stealing thread pool. Every worker owns a deque: it pushes and pops
+// its own tasks at the back and steals from the front of the others. A
+// thread in run() works through that call's chunks alongside the workers
+// and then sleeps until the chunks others took are done, so tasks may call
+// run() recursively without starving the pool or picking up unrelated work.
+class Pool final {
+    using Task = std::function<void()>;
+
+    struct Queue final {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::jthread> workers;
+
+    std::atomic<std::size_t> pending{0};
+    std::atomic<std::size_t> next{0};
+
+    std::mutex sleep;
+    std::condition_variable wake;
+    bool stopping{false};
+
+    void push(Task task);
+
+    [[nodiscard]] bool pop(Task &task);
+
+    void work(std::size_t index);
+
+  public:
+    explicit Pool(std::size_t workers);
+
+    Pool(Pool const &) = delete;
+
+    Pool &operator=(Pool const &) = delete;
+
+    ~Pool();
+
+    static Pool &shared();
+
+    [[nodiscard]] std::size_t size() const;
+
+    // Queues a task that must not throw.
+    void submit(Task task);
+
+    // Calls body(i) for every i below count and returns once all calls
+    // have finished. If any call throws, higher indices are skipped and the
+    // exception of the lowest index is rethrown.
+    void run(std::size_t count, std::function<void(std::size_t)> const &body);
+};
+
+// Block size for count independent items under the current Context, or 0
+// when they should be processed on the calling thread.
+[[nodiscard]] std::size_t parallel_block(std::size_t count);
+
+// Calls body(i) for every i below count, on the shared pool when the count
+// times the number of items each call covers reaches the current Context's
+// parallel threshold. Workers run under the caller's Context and
+// cancellation State.
+void parallel_for(
+    std::size_t count, std::function<void(std::size_t)> const &body,
+    std::size_t items = 1
+);
+
+// Folds items left to right with combine(lhs, std::move(rhs)). Above the
+// parallel threshold every block is folded on the pool and the block results
+// are then combined pairwise, so the grouping depends on the threshold only,
+// never on scheduling.
+template <typename T, typename Combine>
+[[nodiscard]] T parallel_reduce(std::vector<T> items, Combine const &combine) {
+    if (items.empty())
+        return T{};
+
+    std::size_t block = parallel_block(items.size());
+
+    if (!block) {
+        for (std::size_t i = 1; i < items.size(); ++i)
+            combine(items[0], std::move(items[i]));
+
+        return std::move(items[0]);
+    }
+
+    while (items.size() > 1) {
+        std::size_t const count = (items.size() + block - 1) / block;
+
+        parallel_for(
+            count,
+            [&items, &combine, block](std::size_t const i) {
+                std::size_t const end =
+                    std::min(items.size(), (i + 1) * block);
+
+                for (std::size_t j = i * block + 1; j < end; ++j)
+                    combine(items[i * block], std::move(items[j]));
+            },
+            block
+        );
+
+        for (std::size_t i = 1; i < count; ++i)
+            items[i] = std::move(items[i * block]);
+
+        items.resize(count);
+        block = 2;
+    }
+
+    return std::move(items[0]);
+}
+} // namespace mlp
+
+#endif // POOL_H
@@ -0,0 +1,129 @@
+#ifndef PROGRAM_H
+#define PROGRAM_H
+
+#include "token.h"
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mlp {
+enum class OpCode : std::uint32_t {
+    constant, // push value
+    load,     // push value * inputs[operand]
+    add,      // replace top operand entries with their sum
+    mul,      // replace top operand entries with their product
+    neg,      // negate top
+    scale,    // multiply top by value
+    power,    // raise top to the constant value
+    pow,      // replace top two entries with base ^ power
+    call,     // apply built-in function operand to top
+    store,    // copy top into register operand
+    fetch,    // push register operand
+    output    // pop top into output operand
+};
+
+struct Instruction final {
+    OpCode code;
+    std::uint32_t operand;
+    Constant value;
+};
+
+// A program without output instructions has a single output, the value left
+// on top of the stack.
+struct ProgramView final {
+    std::span<Instruction const> instructions;
+    std::string_view inputs;
+    std::uint32_t depth;
+    std::uint32_t registers{0};
+    std::uint32_t outputs{1};
+};
+
+class Program final {
+    std::vector<Instruction> instructions;
+    std::string inputs;
+    std::uint32_t depth{0};
+    std::uint32_t registers{0};
+    std::uint32_t outputs{1};
+
+    class Builder;
+
+  public:
+    explicit Program(Token const &token);
+
+    // Compiles every token into one program with an output each. A
+    // subexpression that occurs more than once, within a token or across
+    // them, is computed once and kept in a register.
+    explicit Program(std::span<Token const> tokens);
+
+    [[nodiscard]] std::string_view variables() const;
+
+    operator ProgramView() const;
+};
+
+// Programs run in the scalar type of their inputs, with their constants
+// rounded to it. The single evaluation returns output 0.
+[[nodiscard]] float
+evaluate(ProgramView program, std::span<float const> inputs);
+
+[[nodiscard]] Constant
+evaluate(ProgramView program, std::span<Constant const> inputs);
+
+[[nodiscard]] long double
+evaluate(ProgramView program, std::span<long double const> inputs);
+
+[[nodiscard]] Constant
+evaluate(ProgramView program, std::map<Variable, Constant> const &values);
+
+// Evaluates the program for count = results.size() / outputs rows. inputs
+// holds one column of count values for each of the program's variables, in
+// order, and results receives one column of count values per output.
+void evaluate(
+    ProgramView program, std::span<float const> inputs, std::span<float> results
+);
+
+void evaluate(
+    ProgramView program, std::span<Constant const> inputs,
+    std::span<Constant> results
+);
+
+void evaluate(
+    ProgramView program, std::span<long double const> inputs,
+    std::span<long double> results
+);
+
+// Where one input of a batch comes from: row j reads source[i * stride],
+// with i = rows[j] when rows is given and j otherwise. A stride of 0
+// repeats source[0] in every row.
+struct Column final {
+    Constant const *source;
+    std::size_t stride = 1;
+    std::span<std::size_t const> rows = {};
+};
+
+// Gathers count rows from one column per input of the program, evaluates
+// them and stores the outputs row by row in results. scratch holds the
+// gathered columns and may be kept between calls.
+void evaluate(
+    ProgramView program, std::span<Column const> columns, std::size_t count,
+    std::span<Constant> results, std::vector<Constant> &scratch
+);
+
+// Calls body(begin, width) for the blocks of rows that cover count, sized
+// for the batch evaluator. Blocks run on the shared Pool when the current
+// Context's parallel threshold allows.
+void parallel_blocks(
+    std::size_t count,
+    std::function<void(std::size_t, std::size_t)> const &body
+);
+
+// Checks that every instruction is a known opcode with its operand in range
+// and that the stack never underflows or outgrows depth, which makes a
+// program from an untrusted source safe to evaluate.
+[[nodiscard]] bool verify(ProgramView program);
+} // namespace mlp
+
+#endif // PROGRAM_H
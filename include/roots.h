@@ -0,0 +1,51 @@
+#ifndef ROOTS_H
+#define ROOTS_H
+
+#include "program.h"
+#include "variable.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace mlp {
+enum class RootStatus : std::uint8_t {
+    converged,
+    unbracketed, // f has the same sign at both ends of the interval
+    exhausted    // ran out of iterations; the root holds the last iterate
+};
+
+struct RootOptions final {
+    // Relative to max(|x|, 1).
+    Constant tolerance = 1e-12;
+    std::uint32_t iterations = 100;
+};
+
+// Solves f(x, parameters) = 0 for x over many parameter rows at once. f and
+// its derivative are compiled once; every row then runs Newton's method
+// inside a bracket, falling back to bisection whenever a step would leave
+// it. Rows are solved in the blocks of parallel_blocks.
+class RootFinder final {
+    Program function;
+    Program slope;
+    Variable variable;
+    std::string names;
+
+  public:
+    RootFinder(Token const &token, Variable variable);
+
+    // The variables other than x, in the order of the parameter columns.
+    [[nodiscard]] std::string_view parameters() const;
+
+    // lower, upper, roots and status hold one entry per row; parameters
+    // holds one column of rows values for each of parameters(), in order.
+    void solve(
+        std::span<Constant const> lower, std::span<Constant const> upper,
+        std::span<Constant const> parameters, std::span<Constant> roots,
+        std::span<RootStatus> status, RootOptions const &options = {}
+    ) const;
+};
+} // namespace mlp
+
+#endif // ROOTS_H
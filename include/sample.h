@@ -0,0 +1,121 @@
+#ifndef SAMPLE_H
+#define SAMPLE_H
+
+#include "program.h"
+#include "variable.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mlp {
+struct Sample final {
+    Constant x;
+    Constant y;
+};
+
+struct SurfaceSample final {
+    Constant x;
+    Constant y;
+    Constant z;
+};
+
+struct SampleOptions final {
+    // How far the value at a cell's centre may stray from the average of
+    // its corners, relative to the range of the initial samples.
+    Constant tolerance = 1e-3;
+    // Cells per axis of the initial uniform grid.
+    std::uint32_t initial = 32;
+    // Times a cell of the initial grid may be halved.
+    std::uint32_t depth = 10;
+    // Refinement stops splitting cells before the samples exceed this.
+    std::size_t limit = std::size_t{1} << 20;
+};
+
+// Samples a function over an interval or a rectangle, starting from a
+// uniform grid and halving every cell whose centre does not lie on the
+// interpolation of its corners, so flat stretches get few samples and
+// curved ones many. Each level of refinement is one batch through the
+// compiled evaluator. With slopes, the derivative along every axis is
+// compiled alongside the function, and a cell is also split when the
+// tangents at its corners miss the centre, which catches features that
+// happen to lie on a chord.
+class Sampler final {
+    std::vector<Variable> axes;
+    bool slopes;
+    Program program;
+    std::string names;
+    // For every input, the axis it is, or the axis count plus its index
+    // among the parameters.
+    std::vector<std::uint32_t> slots;
+
+    void run(
+        std::span<Constant const> parameters,
+        std::span<Constant const> coordinates, std::span<Constant> results
+    ) const;
+
+    void refine(
+        std::span<Constant const> lower, std::span<Constant const> upper,
+        std::span<Constant const> parameters, SampleOptions const &options,
+        std::function<void(std::span<Constant const>)> const &sink
+    ) const;
+
+  public:
+    Sampler(
+        Token const &token, std::vector<Variable> axes, bool slopes = false
+    );
+
+    // The variables other than the axes, in the order the sampling
+    // functions take their values.
+    [[nodiscard]] std::string_view parameters() const;
+
+    // Passes the samples of a function of one axis to sink a chunk at a
+    // time, in increasing x.
+    void curve(
+        Constant lower, Constant upper, std::span<Constant const> parameters,
+        std::function<void(std::span<Sample const>)> const &sink,
+        SampleOptions const &options = {}
+    ) const;
+
+    // Stores the first samples.size() samples and returns how many there
+    // are in all.
+    std::size_t curve(
+        Constant lower, Constant upper, std::span<Constant const> parameters,
+        std::span<Sample> samples, SampleOptions const &options = {}
+    ) const;
+
+    // Writes every sample as two doubles in native byte order.
+    void curve(
+        Constant lower, Constant upper, std::span<Constant const> parameters,
+        std::ostream &output, SampleOptions const &options = {}
+    ) const;
+
+    // The same for a function of two axes, row by row in increasing y and
+    // then x. Refined rows hold more samples than coarse ones.
+    void surface(
+        std::array<Constant, 2> lower, std::array<Constant, 2> upper,
+        std::span<Constant const> parameters,
+        std::function<void(std::span<SurfaceSample const>)> const &sink,
+        SampleOptions const &options = {}
+    ) const;
+
+    std::size_t surface(
+        std::array<Constant, 2> lower, std::array<Constant, 2> upper,
+        std::span<Constant const> parameters,
+        std::span<SurfaceSample> samples, SampleOptions const &options = {}
+    ) const;
+
+    void surface(
+        std::array<Constant, 2> lower, std::array<Constant, 2> upper,
+        std::span<Constant const> parameters, std::ostream &output,
+        SampleOptions const &options = {}
+    ) const;
+};
+} // namespace mlp
+
+#endif // SAMPLE_H
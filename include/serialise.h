@@ -0,0 +1,85 @@
+#ifndef SERIALISE_H
+#define SERIALISE_H
+
+#include "token.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace mlp {
+// Binary layout (little-endian), version 1:
+//   header     "MLPB" u16 version
+//   constant   u8 0, f64 value
+//   variable   u8 1, f64 coefficient, u8 name
+//   function   u8 2, varint id << 1 | new, [varint length, name if new],
+//              varint count, parameters
+//   term       u8 3, f64 coefficient, base, power
+//   terms      u8 4, f64 coefficient, varint count, terms
+//   expression u8 5, varint count, (u8 sign, token) per entry
+//   reference  u8 6, varint distance back to an identical earlier node
+class BinaryWriter final {
+    std::ostream &output;
+    std::uint64_t offset{0};
+
+    std::map<std::string, std::uint64_t> functions;
+    std::map<std::string, std::uint64_t> shapes;
+    std::unordered_map<std::uint64_t, std::uint64_t> emitted;
+    std::unordered_map<Token const *, std::uint64_t> ids;
+
+    std::uint64_t intern(Token const &token);
+
+    void encode(std::string &buffer, Token const &token);
+
+  public:
+    static constexpr std::uint16_t version = 1;
+
+    explicit BinaryWriter(std::ostream &output);
+
+    BinaryWriter &operator<<(Token const &token);
+};
+
+class BinaryReader final {
+    struct Decoded final {
+        OwnedToken token;
+        std::uint64_t nodes;
+    };
+
+    std::span<std::byte const> buffer;
+    std::size_t offset{0};
+
+    std::vector<std::string> functions;
+    // Offsets of the nodes decoded in full, the only ones a reference may
+    // point back to.
+    std::unordered_set<std::size_t> finished;
+    // Nodes a reference points to, decoded once and copied for every
+    // reference after that.
+    std::unordered_map<std::size_t, Decoded> referenced;
+    // Nodes produced so far, counting those every reference copies.
+    std::uint64_t nodes{0};
+
+    Token decode(std::size_t &position, std::size_t depth);
+
+    Token node(std::size_t &position, std::size_t depth);
+
+  public:
+    explicit BinaryReader(std::span<std::byte const> buffer);
+
+    [[nodiscard]] bool empty() const;
+
+    BinaryReader &operator>>(Token &token);
+};
+
+[[nodiscard]] std::string serialise(Token const &token);
+
+[[nodiscard]] Token deserialise(std::string_view buffer);
+} // namespace mlp
+
+#endif // SERIALISE_H
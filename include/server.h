@@ -0,0 +1,73 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+// Serves requests over a Unix domain socket, one JSON object per line:
+//
+//   {"id": 1, "op": "derivative", "expression": "sin(x)*x", "variable": "x",
+//    "order": 2, "timeout": 500}
+//
+// op is one of parse, simplify, derivative, integral, evaluate and stats.
+// evaluate takes "values": {"x": 0.5, ...}. order is at most 64, and timeout
+// is a limit in milliseconds of at most a day that defaults to the server's.
+// id must be a number or a string. Every request gets one line back carrying
+// its id and either "result" (the expression, or a number for evaluate) or
+// "error". Responses on a connection may arrive out of order.
+//
+// Requests wait in a bounded queue for the workers; once it is full the
+// server stops reading from connections until a slot frees up. Both the
+// number of connections and the time a response may wait for its client to
+// read are limited too. Parsed,
+// simplified and compiled forms of every expression text are cached and
+// shared by all workers. stats reports the queue, the caches and the
+// operation counters, which a server switches on for the whole process in
+// builds with MLP_COUNTERS.
+namespace mlp {
+struct ServerOptions final {
+    std::size_t workers = std::max(std::thread::hardware_concurrency(), 1u);
+    std::size_t queue = 256;
+    std::size_t cache = 4096;
+    // Connections served at once; further clients get an error and are
+    // closed.
+    std::size_t connections = 256;
+    // Longest request line in bytes. A connection that sends a longer one
+    // gets an error and is closed.
+    std::size_t line = std::size_t{1} << 20;
+    // Time limit in milliseconds for requests that do not set their own;
+    // 0 leaves them unlimited.
+    double timeout = 10000;
+    // Time limit in milliseconds for sending a response to a client that is
+    // not reading them; the connection is closed once it passes. 0 waits
+    // forever.
+    double write = 5000;
+};
+
+class Server final {
+    struct State;
+
+    std::unique_ptr<State> state;
+
+  public:
+    explicit Server(
+        std::filesystem::path const &path, ServerOptions const &options = {}
+    );
+
+    Server(Server const &) = delete;
+
+    Server &operator=(Server const &) = delete;
+
+    ~Server();
+
+    // Accepts connections until stop() is called.
+    void serve();
+
+    void stop();
+};
+} // namespace mlp
+
+#endif // SERVER_H
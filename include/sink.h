@@ -0,0 +1,44 @@
+#ifndef SINK_H
+#define SINK_H
+
+#include "token.h"
+
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace mlp {
+class Sink final {
+    std::string buffer;
+    std::ostream *stream{nullptr};
+
+  public:
+    Sink() = default;
+
+    explicit Sink(std::ostream &stream);
+
+    Sink(Sink const &) = delete;
+
+    Sink &operator=(Sink const &) = delete;
+
+    ~Sink();
+
+    Sink &operator<<(char character);
+
+    Sink &operator<<(std::string_view string);
+
+    Sink &operator<<(Constant value);
+
+    Sink &operator<<(Sign sign);
+
+    Sink &operator<<(Token const &token);
+
+    Sink &fixed(Constant value);
+
+    void flush();
+
+    [[nodiscard]] std::string str() &&;
+};
+} // namespace mlp
+
+#endif // SINK_H
@@ -0,0 +1,41 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include "token.h"
+
+#include <array>
+#include <cstddef>
+
+// Shape and memory footprint of a Token tree. Nodes are counted per variant
+// alternative, in index order. inline_bytes is the root Token itself;
+// heap_bytes is everything the tree allocates: Term base/power payloads,
+// vector capacity of Terms, Expression and Function parameters, and Function
+// names too long for the small string buffer. variant_overhead is the space
+// each node wastes over its active alternative. A subtree is shared when a
+// structurally equal subtree was already seen; shared_bytes is what those
+// duplicates cost.
+namespace mlp {
+struct Statistics final {
+    std::array<std::size_t, std::variant_size_v<Token>> nodes{};
+    std::size_t depth{0};
+    std::size_t heap_bytes{0};
+    std::size_t inline_bytes{0};
+    std::size_t variant_overhead{0};
+    std::size_t unique_subtrees{0};
+    std::size_t shared_subtrees{0};
+    std::size_t shared_bytes{0};
+
+    [[nodiscard]] std::size_t node_count() const;
+
+    [[nodiscard]] std::size_t total_bytes() const;
+
+    friend Statistics statistics(Token const &token);
+
+  private:
+    class Collector;
+};
+
+[[nodiscard]] Statistics statistics(Token const &token);
+} // namespace mlp
+
+#endif // STATISTICS_H
@@ -0,0 +1,68 @@
+#ifndef SURROGATE_H
+#define SURROGATE_H
+
+#include "token.h"
+#include "variable.h"
+
+#include <cstdint>
+#include <map>
+#include <span>
+#include <vector>
+
+namespace mlp {
+struct SurrogateOptions final {
+    // Target error relative to the largest |f| on the domain.
+    Constant tolerance = 1e-12;
+    // Highest degree a piece may reach before it is halved. Evaluation
+    // costs one multiply-add per degree, so low degrees over more pieces
+    // are cheaper.
+    std::uint32_t degree = 32;
+    // Most pieces the domain may be split into.
+    std::uint32_t pieces = 1024;
+};
+
+// Replaces a function of one variable on an interval by piecewise Chebyshev
+// series. Every piece doubles its degree until the trailing coefficients
+// fall below the tolerance, and a piece that does not converge within the
+// maximum degree, or meets a non-finite value, is halved. Evaluating the
+// surrogate then takes a binary search and one Clenshaw recurrence however
+// many built-in functions the original calls.
+class Surrogate final {
+    // Piece i covers [breaks[i], breaks[i + 1]] with the coefficients from
+    // offsets[i] up to offsets[i + 1].
+    std::vector<Constant> breaks;
+    std::vector<std::size_t> offsets;
+    std::vector<Constant> coefficients;
+    Constant bound{0};
+
+    // The piece holding x, or breaks.size() outside the domain.
+    [[nodiscard]] std::size_t locate(Constant x) const;
+
+  public:
+    // values fixes every other variable of the token.
+    Surrogate(
+        Token const &token, Variable variable, Constant lower, Constant upper,
+        std::map<Variable, Constant> const &values = {},
+        SurrogateOptions const &options = {}
+    );
+
+    // The larger of the truncated coefficients' size and the largest error
+    // measured between the interpolation points, over all pieces. It may
+    // exceed the tolerance when the piece limit was reached first.
+    [[nodiscard]] Constant error() const;
+
+    [[nodiscard]] std::size_t pieces() const;
+
+    // The highest degree of any piece.
+    [[nodiscard]] std::size_t degree() const;
+
+    // NaN outside the domain.
+    [[nodiscard]] Constant evaluate(Constant x) const;
+
+    void evaluate(
+        std::span<Constant const> x, std::span<Constant> results
+    ) const;
+};
+} // namespace mlp
+
+#endif // SURROGATE_H
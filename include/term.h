@@ -23,6 +23,8 @@ struct Term final {
 
     explicit operator std::string() const;
 
+    void write(Sink &sink) const;
+
     [[nodiscard]] Term operator-() const;
 
     Term &operator*=(Constant rhs);
@@ -22,6 +22,8 @@ struct Terms final {
 
     explicit operator std::string() const;
 
+    void write(Sink &sink) const;
+
     [[nodiscard]] Terms operator-() const;
 
     Terms &operator*=(Variable variable);
@@ -14,6 +14,7 @@ class Function;
 struct Term;
 struct Terms;
 class Expression;
+class Sink;
 
 using Token =
     std::variant<Constant, Variable, Function, Term, Terms, Expression>;
@@ -0,0 +1,47 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "token.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace mlp::trace {
+inline std::atomic<bool> g_enabled{false};
+
+void start(std::string const &path);
+
+void stop();
+
+[[nodiscard]] bool enabled();
+
+class Span final {
+    std::string_view name;
+    std::string_view key;
+    std::string_view detail;
+    std::int64_t begin{-1};
+    std::uint32_t depth{0};
+
+    void open(std::string_view key, std::string_view detail);
+
+    void close() const;
+
+  public:
+    Span(std::string_view name, Token const &token);
+
+    explicit Span(std::string_view name, std::string_view detail = "");
+
+    Span(Span const &) = delete;
+
+    Span &operator=(Span const &) = delete;
+
+    ~Span() {
+        if (this->begin >= 0)
+            this->close();
+    }
+};
+} // namespace mlp::trace
+
+#endif // TRACE_H
@@ -26,6 +26,8 @@ class Variable final {
 
     explicit operator std::string() const;
 
+    void write(Sink &sink) const;
+
     [[nodiscard]] Variable operator-() const;
 
     [[nodiscard]] bool operator<(Variable) const;
@@ -37,6 +39,10 @@ class Variable final {
     Variable &operator/=(Constant rhs);
 
     friend std::istream &operator>>(std::istream &input, Variable &output);
+
+    friend class BinaryWriter;
+    friend class Program;
+    friend struct Statistics;
 };
 
 [[nodiscard]] bool is_dependent_on(Variable token, Variable variable);
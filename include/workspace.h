@@ -0,0 +1,89 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include "context.h"
+#include "program.h"
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mlp {
+// Named bindings that may call each other, such as f(x) = x^2 and
+// g(x) = f(x) + 1. Every binding keeps its simplified value, with the
+// bindings it calls inlined, and the Program compiled from it. Redefining a
+// binding recomputes it and the bindings downstream of it, in dependency
+// order, and leaves the rest untouched.
+class Workspace final {
+    struct Binding;
+
+    Context scope;
+
+    std::map<std::string, std::unique_ptr<Binding>> bindings;
+
+    void collect(Token const &token, std::set<std::string> &names) const;
+
+    void collect(std::string_view source, std::set<std::string> &names) const;
+
+    [[nodiscard]] std::vector<std::string> downstream(std::string const &name
+    ) const;
+
+    void link(std::string const &name, std::set<std::string> dependencies);
+
+    void recompute(std::string const &name);
+
+    std::vector<std::string> update(
+        std::string const &name, Binding binding,
+        std::set<std::string> dependencies
+    );
+
+  public:
+    Workspace();
+
+    Workspace(Workspace const &) = delete;
+
+    Workspace &operator=(Workspace const &) = delete;
+
+    ~Workspace();
+
+    // Parses "f(x, y) = body" against the current bindings and binds it.
+    std::vector<std::string> bind(std::string const &definition);
+
+    // Returns the names that were recomputed, starting with name. Throws and
+    // leaves the workspace unchanged if the definition would be cyclic or
+    // any recomputation fails.
+    std::vector<std::string> bind(
+        std::string const &name, std::vector<Variable> parameters, Token body
+    );
+
+    // Throws if other bindings still call name.
+    void erase(std::string const &name);
+
+    [[nodiscard]] bool contains(std::string const &name) const;
+
+    [[nodiscard]] std::vector<std::string> names() const;
+
+    [[nodiscard]] std::vector<Variable> const &
+    parameters(std::string const &name) const;
+
+    [[nodiscard]] Token const &value(std::string const &name) const;
+
+    // Empty when the value calls a function that cannot be compiled.
+    [[nodiscard]] std::optional<ProgramView> program(std::string const &name
+    ) const;
+
+    // Parses an expression that may call the bindings.
+    [[nodiscard]] Token tokenise(std::string const &expression);
+
+    // Simplifies token with every call to a binding inlined.
+    [[nodiscard]] Token resolved(Token const &token);
+
+    [[nodiscard]] Context &context();
+};
+} // namespace mlp
+
+#endif // WORKSPACE_H
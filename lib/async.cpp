@@ -0,0 +1,78 @@
+#include "../include/async.h"
+
+#include "../include/cancellation.h"
+#include "../include/context.h"
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/pool.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+#include "../include/variable.h"
+
+#include <memory>
+
+namespace {
+template <typename Operation>
+std::future<mlp::Token> launch(
+    std::stop_token stop, mlp::Budget const &budget, Operation operation
+) {
+    auto promise = std::make_shared<std::promise<mlp::Token>>();
+    auto future = promise->get_future();
+
+    mlp::Context const &current = mlp::Context::current();
+
+    // The job owns a copy of the caller's definitions rather than a
+    // reference to its context, which may be gone before the job runs.
+    mlp::Pool::shared().submit([promise, registry = current.snapshot(),
+                                threshold = current.parallel_threshold(),
+                                stop = std::move(stop), budget,
+                                operation = std::move(operation)] {
+        mlp::Context context{registry};
+        context.parallelise(threshold);
+
+        mlp::Context::Scope const scope{context};
+        mlp::cancellation::Scope const cancellation{stop, budget};
+
+        try {
+            mlp::cancellation::checkpoint();
+            promise->set_value(operation());
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+
+    return future;
+}
+} // namespace
+
+std::future<mlp::Token> mlp::simplified_async(
+    Token token, std::stop_token stop, Budget const &budget
+) {
+    return launch(std::move(stop), budget, [token = std::move(token)] {
+        return simplified(token);
+    });
+}
+
+std::future<mlp::Token> mlp::derivative_async(
+    Token token, Variable const variable, std::uint32_t const order,
+    std::stop_token stop, Budget const &budget
+) {
+    return launch(
+        std::move(stop), budget,
+        [token = std::move(token), variable, order] {
+            return derivative(token, variable, order);
+        }
+    );
+}
+
+std::future<mlp::Token> mlp::integral_async(
+    Token token, Variable const variable, std::stop_token stop,
+    Budget const &budget
+) {
+    return launch(
+        std::move(stop), budget,
+        [token = std::move(token), variable] {
+            return integral(token, variable);
+        }
+    );
+}
@@ -0,0 +1,102 @@
+#include "../include/cancellation.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace {
+thread_local std::shared_ptr<mlp::cancellation::State> t_state;
+
+std::string describe(
+    mlp::Resource const resource, std::uint64_t const limit,
+    std::uint64_t const used
+) {
+    constexpr std::string_view k_names[]{"Time", "Node", "Memory"};
+
+    return std::string{k_names[static_cast<std::size_t>(resource)]} +
+           " budget exceeded: " + std::to_string(used) + " of " +
+           std::to_string(limit) + "!";
+}
+} // namespace
+
+mlp::Cancelled::Cancelled() : std::runtime_error{"Operation cancelled!"} {}
+
+mlp::BudgetExceeded::BudgetExceeded(
+    Resource const resource, std::uint64_t const limit,
+    std::uint64_t const used
+)
+    : std::runtime_error{describe(resource, limit, used)}, resource(resource),
+      limit(limit), used(used) {}
+
+mlp::cancellation::Scope::Scope(std::stop_token token, Budget const &budget)
+    : previous(std::exchange(t_state, std::make_shared<State>())) {
+    t_state->token = std::move(token);
+    t_state->budget = budget;
+    t_state->start = std::chrono::steady_clock::now();
+
+    if (budget.time != std::chrono::steady_clock::duration::max())
+        t_state->budget.deadline =
+            std::min(budget.deadline, t_state->start + budget.time);
+}
+
+mlp::cancellation::Scope::Scope(std::shared_ptr<State> state)
+    : previous(std::exchange(t_state, std::move(state))) {}
+
+mlp::cancellation::Scope::~Scope() { t_state = std::move(this->previous); }
+
+std::shared_ptr<mlp::cancellation::State> mlp::cancellation::current() {
+    return t_state;
+}
+
+void mlp::cancellation::checkpoint() {
+    State const *state = t_state.get();
+
+    if (!state)
+        return;
+
+    if (state->token.stop_requested())
+        throw Cancelled{};
+
+    using Clock = std::chrono::steady_clock;
+
+    if (state->budget.deadline == Clock::time_point::max())
+        return;
+
+    if (auto const now = Clock::now(); now > state->budget.deadline) {
+        auto const milliseconds = [state](Clock::time_point const end) {
+            return static_cast<std::uint64_t>(
+                std::chrono::ceil<std::chrono::milliseconds>(
+                    end - state->start
+                )
+                    .count()
+            );
+        };
+
+        throw BudgetExceeded{
+            Resource::time, milliseconds(state->budget.deadline),
+            milliseconds(now)
+        };
+    }
+}
+
+void mlp::cancellation::charge(
+    std::uint64_t const nodes, std::uint64_t const bytes
+) {
+    State *state = t_state.get();
+
+    if (!state)
+        return;
+
+    std::uint64_t const total_nodes =
+        state->nodes.fetch_add(nodes, std::memory_order_relaxed) + nodes;
+    std::uint64_t const total_bytes =
+        state->memory.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+    if (total_nodes > state->budget.nodes)
+        throw BudgetExceeded{Resource::nodes, state->budget.nodes, total_nodes};
+
+    if (total_bytes > state->budget.memory)
+        throw BudgetExceeded{
+            Resource::memory, state->budget.memory, total_bytes
+        };
+}
@@ -0,0 +1,179 @@
+#include "../include/context.h"
+
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+#include "../include/variable.h"
+
+#include <set>
+#include <utility>
+
+namespace {
+thread_local mlp::Context *t_current = nullptr;
+// The context the pinned registry belongs to, if any.
+thread_local mlp::Context const *t_pinned = nullptr;
+thread_local std::shared_ptr<mlp::Registry const> t_registry;
+} // namespace
+
+mlp::Context::Scope::Scope(
+    Context &context, std::shared_ptr<Registry const> registry
+)
+    : previous(t_current), previous_pinned(t_pinned),
+      previous_registry(std::move(t_registry)) {
+    t_current = &context;
+    t_pinned = registry ? &context : nullptr;
+    t_registry = std::move(registry);
+}
+
+mlp::Context::Scope::~Scope() {
+    t_current = this->previous;
+    t_pinned = this->previous_pinned;
+    t_registry = std::move(this->previous_registry);
+}
+
+mlp::Context::Pin::Pin() : outermost(!t_pinned) {
+    if (this->outermost) {
+        Context const &context = current();
+        t_registry = context.snapshot();
+        t_pinned = &context;
+    }
+}
+
+mlp::Context::Pin::~Pin() {
+    if (this->outermost) {
+        t_pinned = nullptr;
+        t_registry.reset();
+    }
+}
+
+mlp::Context::Context() : registry(std::make_shared<Registry const>()) {}
+
+mlp::Context::Context(std::shared_ptr<Registry const> registry)
+    : registry(std::move(registry)) {}
+
+mlp::Context &mlp::Context::global() {
+    static Context context;
+
+    return context;
+}
+
+mlp::Context &mlp::Context::current() {
+    return t_current ? *t_current : global();
+}
+
+std::shared_ptr<mlp::Registry const> mlp::Context::snapshot() const {
+    if (t_pinned == this)
+        return t_registry;
+
+    return this->registry.load(std::memory_order_acquire);
+}
+
+void mlp::Context::define(std::string const &name, Definition definition) {
+    if (builtin_id(name))
+        throw std::runtime_error{"Cannot redefine built-in functions!"};
+
+    std::lock_guard const lock{this->writer};
+
+    auto registry = std::make_shared<Registry>(
+        *this->registry.load(std::memory_order_acquire)
+    );
+    registry->lambdas.erase(name);
+    registry->functions[name] = std::move(definition);
+
+    this->registry.store(std::move(registry), std::memory_order_release);
+}
+
+void mlp::Context::define(
+    std::string const &name, std::vector<Variable> parameters, Token body
+) {
+    if (builtin_id(name))
+        throw std::runtime_error{"Cannot redefine built-in functions!"};
+
+    std::lock_guard const lock{this->writer};
+
+    auto registry = std::make_shared<Registry>(
+        *this->registry.load(std::memory_order_acquire)
+    );
+
+    // Inlining a body that calls its own name, directly or through other
+    // definitions, would never finish.
+    std::set<std::string> visited;
+
+    auto const calls = [&registry, &name, &visited](
+                           auto const &self, Token const &token
+                       ) -> bool {
+        return std::visit(
+            [&]<typename T>(T const &var) -> bool {
+                if constexpr (std::is_same_v<T, Function>) {
+                    if (var.function == name)
+                        return true;
+
+                    auto const lambda = registry->lambdas.find(var.function);
+
+                    if (lambda != registry->lambdas.end() &&
+                        visited.insert(var.function).second &&
+                        self(self, *lambda->second.body))
+                        return true;
+
+                    for (Token const &parameter : var.parameters)
+                        if (self(self, parameter))
+                            return true;
+                } else if constexpr (std::is_same_v<T, Term>) {
+                    return self(self, *var.base) || self(self, *var.power);
+                } else if constexpr (std::is_same_v<T, Terms>) {
+                    for (Token const &term : var.terms)
+                        if (self(self, term))
+                            return true;
+                } else if constexpr (std::is_same_v<T, Expression>) {
+                    for (auto const &[sign, term] : var.tokens)
+                        if (self(self, term))
+                            return true;
+                }
+
+                return false;
+            },
+            token
+        );
+    };
+
+    if (calls(calls, body))
+        throw std::runtime_error{"Recursive definition!"};
+
+    registry->functions.erase(name);
+    registry->lambdas[name] = {
+        std::move(parameters), std::make_shared<Token const>(std::move(body))
+    };
+
+    this->registry.store(std::move(registry), std::memory_order_release);
+}
+
+void mlp::Context::undef(std::string const &name) {
+    if (builtin_id(name))
+        throw std::runtime_error{"Cannot undefine built-in functions!"};
+
+    std::lock_guard const lock{this->writer};
+
+    auto registry = std::make_shared<Registry>(
+        *this->registry.load(std::memory_order_acquire)
+    );
+    registry->functions.erase(name);
+    registry->lambdas.erase(name);
+
+    this->registry.store(std::move(registry), std::memory_order_release);
+}
+
+bool mlp::Context::is_defined(std::string const &name) const {
+    auto const registry = this->snapshot();
+
+    return registry->functions.contains(name) ||
+           registry->lambdas.contains(name);
+}
+
+void mlp::Context::parallelise(std::size_t const threshold) {
+    this->threshold.store(threshold, std::memory_order_relaxed);
+}
+
+std::size_t mlp::Context::parallel_threshold() const {
+    return this->threshold.load(std::memory_order_relaxed);
+}
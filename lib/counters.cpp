@@ -0,0 +1,90 @@
+#include "../include/counters.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace {
+constexpr std::array<std::string_view, mlp::Counters{}.size()> k_names{
+    "node_allocations",      "term_copies",         "terms_copies",
+    "expression_copies",     "simplified_constant", "simplified_variable",
+    "simplified_function",   "simplified_term",     "simplified_terms",
+    "simplified_expression", "function_tokenise",   "like_term_scans",
+    "like_term_steps"
+};
+
+struct Registry final {
+    std::mutex mutex;
+    std::vector<mlp::counters::Block *> blocks;
+    mlp::Counters retired{};
+};
+
+Registry &registry() {
+    static Registry registry;
+
+    return registry;
+}
+
+struct Registration final {
+    mlp::counters::Block block{};
+
+    Registration() {
+        std::lock_guard const lock{registry().mutex};
+        registry().blocks.push_back(&this->block);
+    }
+
+    Registration(Registration const &) = delete;
+
+    Registration &operator=(Registration const &) = delete;
+
+    ~Registration() {
+        std::lock_guard const lock{registry().mutex};
+
+        for (std::size_t i = 0; i < this->block.size(); ++i)
+            registry().retired[i] +=
+                this->block[i].load(std::memory_order_relaxed);
+
+        std::erase(registry().blocks, &this->block);
+    }
+};
+} // namespace
+
+mlp::counters::Block &mlp::counters::local() {
+    thread_local Registration registration;
+
+    return registration.block;
+}
+
+void mlp::counters::enable(bool const enabled) {
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool mlp::counters::enabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+mlp::Counters mlp::counters::snapshot() {
+    std::lock_guard const lock{registry().mutex};
+
+    Counters result = registry().retired;
+
+    for (Block const *block : registry().blocks)
+        for (std::size_t i = 0; i < result.size(); ++i)
+            result[i] += (*block)[i].load(std::memory_order_relaxed);
+
+    return result;
+}
+
+void mlp::counters::reset() {
+    std::lock_guard const lock{registry().mutex};
+
+    registry().retired = {};
+
+    for (Block *block : registry().blocks)
+        for (auto &value : *block)
+            value.store(0, std::memory_order_relaxed);
+}
+
+std::string_view mlp::counters::name(Counter const counter) {
+    return k_names.at(static_cast<std::size_t>(counter));
+}
@@ -1,6 +1,10 @@
 #include "../include/expression.h"
 
+#include "../include/cancellation.h"
+#include "../include/counters.h"
 #include "../include/function.h"
+#include "../include/pool.h"
+#include "../include/sink.h"
 #include "../include/term.h"
 #include "../include/terms.h"
 #include "../include/variable.h"
@@ -8,13 +12,14 @@
 #include <algorithm>
 #include <map>
 #include <ranges>
-#include <sstream>
 
 mlp::Expression::Expression(Expression const &expression) {
     *this = expression;
 }
 
 mlp::Expression &mlp::Expression::operator=(Expression const &expression) {
+    count(Counter::expression_copies);
+
     this->tokens.clear();
 
     for (auto const &[operation, token] : expression.tokens)
@@ -24,6 +29,8 @@ mlp::Expression &mlp::Expression::operator=(Expression const &expression) {
 }
 
 void mlp::Expression::add_token(Sign const sign, Token const &token) {
+    cancellation::charge(1, sizeof(std::pair<Sign, Token>));
+
     if (sign == Sign::pos)
         *this += token;
 
@@ -32,20 +39,23 @@ void mlp::Expression::add_token(Sign const sign, Token const &token) {
 }
 
 mlp::Expression::operator std::string() const {
-    std::stringstream result;
+    Sink sink;
+    this->write(sink);
+
+    return std::move(sink).str();
+}
 
+void mlp::Expression::write(Sink &sink) const {
     if (this->tokens.size() == 1) {
-        result << this->tokens[0].first << to_string(this->tokens[0].second);
+        sink << this->tokens[0].first << this->tokens[0].second;
     } else {
-        result << '(';
+        sink << '(';
 
         for (auto const &[operation, token] : this->tokens)
-            result << operation << to_string(token);
+            sink << operation << token;
 
-        result << ')';
+        sink << ')';
     }
-
-    return result.str();
 }
 
 mlp::Expression mlp::Expression::operator-() const {
@@ -74,7 +84,11 @@ mlp::Expression &mlp::Expression::operator+=(Constant const rhs) {
     if (rhs == 0)
         return *this;
 
+    count(Counter::like_term_scans);
+
     for (std::int64_t i = 0; i < this->tokens.size(); ++i) {
+        count(Counter::like_term_steps);
+
         auto &[sign, token] = this->tokens[i];
 
         if (!std::holds_alternative<Constant>(token))
@@ -112,7 +126,11 @@ mlp::Expression &mlp::Expression::operator+=(Variable rhs) {
     if (rhs.coefficient == 0)
         return *this;
 
+    count(Counter::like_term_scans);
+
     for (std::int64_t i = 0; i < this->tokens.size(); ++i) {
+        count(Counter::like_term_steps);
+
         auto &[sign, token] = this->tokens[i];
 
         if (std::holds_alternative<Variable>(token)) {
@@ -199,7 +217,11 @@ mlp::Expression &mlp::Expression::operator+=(Term const &rhs) {
 
     auto const &variable = std::get<Variable>(*rhs.base);
 
+    count(Counter::like_term_scans);
+
     for (std::int64_t i = 0; i < this->tokens.size(); ++i) {
+        count(Counter::like_term_steps);
+
         auto &[sign, token] = this->tokens[i];
 
         if (std::holds_alternative<Variable>(token)) {
@@ -292,7 +314,11 @@ mlp::Expression &mlp::Expression::operator-=(Constant const rhs) {
     if (rhs == 0)
         return *this;
 
+    count(Counter::like_term_scans);
+
     for (std::int64_t i = 0; i < this->tokens.size(); ++i) {
+        count(Counter::like_term_steps);
+
         auto &[sign, t] = this->tokens[i];
 
         if (!std::holds_alternative<Constant>(t))
@@ -330,7 +356,11 @@ mlp::Expression &mlp::Expression::operator-=(Variable rhs) {
     if (rhs.coefficient == 0)
         return *this;
 
+    count(Counter::like_term_scans);
+
     for (std::int64_t i = 0; i < this->tokens.size(); ++i) {
+        count(Counter::like_term_steps);
+
         auto &[sign, token] = this->tokens[i];
 
         if (std::holds_alternative<Variable>(token)) {
@@ -417,7 +447,11 @@ mlp::Expression &mlp::Expression::operator-=(Term const &rhs) {
 
     auto const &variable = std::get<Variable>(*rhs.base);
 
+    count(Counter::like_term_scans);
+
     for (std::int64_t i = 0; i < this->tokens.size(); ++i) {
+        count(Counter::like_term_steps);
+
         auto &[sign, token] = this->tokens[i];
 
         if (std::holds_alternative<Variable>(token)) {
@@ -667,8 +701,19 @@ Token simplified(Expression const &token) {
 
     std::vector<std::pair<Sign, Token>> const &tokens = expression.tokens;
 
-    for (auto const &[sign, t] : token.tokens)
-        expression.add_token(sign, simplified(t));
+    if (!parallel_block(token.tokens.size())) {
+        for (auto const &[sign, t] : token.tokens)
+            expression.add_token(sign, simplified(t));
+    } else {
+        std::vector<Token> terms(token.tokens.size());
+
+        parallel_for(terms.size(), [&terms, &token](std::size_t const i) {
+            terms[i] = simplified(token.tokens[i].second);
+        });
+
+        for (std::size_t i = 0; i < terms.size(); ++i)
+            expression.add_token(token.tokens[i].first, terms[i]);
+    }
 
     if (tokens.empty())
         return 0.0;
@@ -701,8 +746,26 @@ Token derivative(
 
     Expression result{};
 
-    for (auto const &[operation, token_] : token.tokens)
-        result.add_token(operation, derivative(token_, variable, 1));
+    if (!parallel_block(token.tokens.size())) {
+        for (auto const &[operation, token_] : token.tokens)
+            result.add_token(operation, derivative(token_, variable, 1));
+    } else {
+        std::vector<Expression> partials(token.tokens.size());
+
+        parallel_for(
+            partials.size(),
+            [&partials, &token, variable](std::size_t const i) {
+                auto const &[sign, term] = token.tokens[i];
+
+                partials[i].add_token(sign, derivative(term, variable, 1));
+            }
+        );
+
+        result = parallel_reduce(
+            std::move(partials),
+            [](Expression &lhs, Expression &&rhs) { lhs += rhs; }
+        );
+    }
 
     auto derivative = simplified(result);
 
@@ -1,176 +1,284 @@
 #include "../include/function.h"
 
+#include "../include/context.h"
+#include "../include/counters.h"
 #include "../include/expression.h"
+#include "../include/kernels.h"
+#include "../include/sink.h"
 #include "../include/term.h"
 #include "../include/terms.h"
+#include "../include/trace.h"
 #include "../include/variable.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <ranges>
-#include <sstream>
+#include <string_view>
 #include <utility>
 
 namespace {
-std::map<std::string, mlp::Constant (*)(mlp::Constant)> const k_functions{
-    {"sin", std::sin},
-    {"cos", std::cos},
-    {"tan", std::tan},
-    {"sec",
-     [](mlp::Constant const val) -> mlp::Constant { return 1 / std::cos(val); }
+using Batch =
+    void (*)(std::span<mlp::Constant const>, std::span<mlp::Constant>);
+using Narrow = void (*)(std::span<float const>, std::span<float>);
+
+struct Builtin final {
+    std::string_view name;
+    std::size_t arity;
+    float (*single)(float);
+    mlp::Constant (*kernel)(mlp::Constant);
+    long double (*extended)(long double);
+    Batch batch;
+    Narrow narrow;
+    std::string_view derivative;
+    std::string_view integral;
+    std::string_view inverse;
+
+    // Kernel is a captureless generic lambda, instantiated once per scalar
+    // type.
+    template <typename Kernel>
+    constexpr Builtin(
+        std::string_view const name, std::size_t const arity, Kernel,
+        Batch const batch, Narrow const narrow,
+        std::string_view const derivative, std::string_view const integral,
+        std::string_view const inverse
+    )
+        : name(name), arity(arity),
+          single([](float const val) -> float { return Kernel{}(val); }),
+          kernel([](mlp::Constant const val) -> mlp::Constant {
+              return Kernel{}(val);
+          }),
+          extended([](long double const val) -> long double {
+              return Kernel{}(val);
+          }),
+          batch(batch), narrow(narrow), derivative(derivative),
+          integral(integral), inverse(inverse) {}
+};
+
+constexpr std::array k_builtins{
+    Builtin{
+        "abs", 1,
+        [](auto const val) { return std::fabs(val); },
+        mlp::kernels::abs, mlp::kernels::abs,
+        "abs({0})/({0})", "({0})abs({0})/2", ""
+    },
+    Builtin{
+        "acos", 1,
+        [](auto const val) { return std::acos(val); },
+        mlp::kernels::acos, mlp::kernels::acos,
+        "-1/((1 - ({0})^2)^0.5)", "({0})acos({0}) - ((1 - ({0})^2)^0.5", "cos"
+    },
+    Builtin{
+        "acosh", 1,
+        [](auto const val) { return std::acosh(val); },
+        mlp::kernels::acosh, mlp::kernels::acosh,
+        "-1/((1 + ({0})^2)^0.5)", "({0})acosh({0}) - ((1 - ({0})^2)^0.5", "cosh"
+    },
+    Builtin{
+        "acot", 1,
+        [](auto const val) { return std::atan(1 / val); },
+        mlp::kernels::acot, mlp::kernels::acot,
+        "-1/(1 + ({0})^2)", "({0})acot({0}) + ln(abs(1 + ({0})^2))/2", "cot"
+    },
+    Builtin{
+        "acoth", 1,
+        [](auto const val) { return std::atanh(1 / val); },
+        mlp::kernels::acoth, mlp::kernels::acoth,
+        "1/(1 - ({0})^2)", "({0})acoth({0}) + ln(({0})^2 - 1)/2", "coth"
+    },
+    Builtin{
+        "acsc", 1,
+        [](auto const val) { return std::asin(1 / val); },
+        mlp::kernels::acsc, mlp::kernels::acsc,
+        "-1/(abs({0})*(({0})^2 - 1)^0.5", "({0})acsc({0}) + acosh(abs({0}))",
+        "csc"
+    },
+    Builtin{
+        "acsch", 1,
+        [](auto const val) { return std::asinh(1 / val); },
+        mlp::kernels::acsch, mlp::kernels::acsch,
+        "1/(abs({0})*(1 - ({0})^2)^0.5",
+        "({0})acsch({0}) + acoth((1 + ({0})^2)^0.5)/({0})", "csch"
+    },
+    Builtin{
+        "asec", 1,
+        [](auto const val) { return std::acos(1 / val); },
+        mlp::kernels::asec, mlp::kernels::asec,
+        "1/(abs({0})*(({0})^2 - 1)^0.5", "({0})asec({0}) - acosh(abs({0}))",
+        "sec"
+    },
+    Builtin{
+        "asech", 1,
+        [](auto const val) { return std::acosh(1 / val); },
+        mlp::kernels::asech, mlp::kernels::asech,
+        "-1/(({0})*(1 - ({0})^2)^0.5",
+        "({0})asech({0}) - 2atan(((1 - ({0})/(1 - ({0}))))^0.5)", "sech"
+    },
+    Builtin{
+        "asin", 1,
+        [](auto const val) { return std::asin(val); },
+        mlp::kernels::asin, mlp::kernels::asin,
+        "1/((1 - ({0})^2)^0.5)", "({0})asin({0}) + ((1 - ({0})^2)^0.5", "sin"
+    },
+    Builtin{
+        "asinh", 1,
+        [](auto const val) { return std::asinh(val); },
+        mlp::kernels::asinh, mlp::kernels::asinh,
+        "1/((1 + ({0})^2)^0.5)", "({0})asinh({0}) - ((1 + ({0})^2)^0.5", "sinh"
+    },
+    Builtin{
+        "atan", 1,
+        [](auto const val) { return std::atan(val); },
+        mlp::kernels::atan, mlp::kernels::atan,
+        "1/(1 + ({0})^2)", "({0})atan({0}) - ln(abs(1 + ({0})^2))/2", "tan"
+    },
+    Builtin{
+        "atanh", 1,
+        [](auto const val) { return std::atanh(val); },
+        mlp::kernels::atanh, mlp::kernels::atanh,
+        "1/(1 - ({0})^2)", "({0})atanh({0}) + ln(1 - ({0})^2)/2", "tanh"
+    },
+    Builtin{
+        "cos", 1,
+        [](auto const val) { return std::cos(val); },
+        mlp::kernels::cos, mlp::kernels::cos,
+        "-sin({0})", "sin({0})", "acos"
     },
-    {"csc",
-     [](mlp::Constant const val) -> mlp::Constant { return 1 / std::sin(val); }
+    Builtin{
+        "cosh", 1,
+        [](auto const val) { return std::cosh(val); },
+        mlp::kernels::cosh, mlp::kernels::cosh,
+        "sinh({0})", "sinh({0})", "acosh"
     },
-    {"cot",
-     [](mlp::Constant const val) -> mlp::Constant { return 1 / std::tan(val); }
+    Builtin{
+        "cot", 1,
+        [](auto const val) { return 1 / std::tan(val); },
+        mlp::kernels::cot, mlp::kernels::cot,
+        "-csc({0})^2", "ln(abs(csc({0}) - cot({0})))", "acot"
     },
-    {"sinh", std::sinh},
-    {"cosh", std::cosh},
-    {"tanh", std::tanh},
-    {"sech",
-     [](mlp::Constant const val) -> mlp::Constant { return 1 / std::cosh(val); }
+    Builtin{
+        "coth", 1,
+        [](auto const val) { return 1 / std::tanh(val); },
+        mlp::kernels::coth, mlp::kernels::coth,
+        "-csch({0})^2", "ln(abs(sinh({0})))", "acoth"
     },
-    {"csch",
-     [](mlp::Constant const val) -> mlp::Constant { return 1 / std::sinh(val); }
+    Builtin{
+        "csc", 1,
+        [](auto const val) { return 1 / std::sin(val); },
+        mlp::kernels::csc, mlp::kernels::csc,
+        "-csc({0})*cot({0})", "ln(abs(sin({0})))", "acsc"
     },
-    {"coth",
-     [](mlp::Constant const val) -> mlp::Constant { return 1 / std::tanh(val); }
+    Builtin{
+        "csch", 1,
+        [](auto const val) { return 1 / std::sinh(val); },
+        mlp::kernels::csch, mlp::kernels::csch,
+        "-csch({0})*cot({0})", "ln(abs(coth({0}) - csch({0})))", "acsch"
     },
-    {"asin", std::asin},
-    {"acos", std::acos},
-    {"atan", std::atan},
-    {"asec",
-     [](mlp::Constant const val) -> mlp::Constant { return std::acos(1 / val); }
+    Builtin{
+        "ln", 1,
+        [](auto const val) { return std::log(val); },
+        mlp::kernels::ln, mlp::kernels::ln,
+        "1/({0})", "({0})ln(abs({0})) - ({0})", ""
     },
-    {"acsc",
-     [](mlp::Constant const val) -> mlp::Constant { return std::asin(1 / val); }
+    Builtin{
+        "sec", 1,
+        [](auto const val) { return 1 / std::cos(val); },
+        mlp::kernels::sec, mlp::kernels::sec,
+        "sec({0})*tan({0})", "ln(abs(sec({0}) + tan({0})))", "asec"
     },
-    {"acot",
-     [](mlp::Constant const val) -> mlp::Constant { return std::atan(1 / val); }
+    Builtin{
+        "sech", 1,
+        [](auto const val) { return 1 / std::cosh(val); },
+        mlp::kernels::sech, mlp::kernels::sech,
+        "sech({0})*tanh({0})", "atan(sinh({0}))", "asech"
     },
-    {"asinh", std::asinh},
-    {"acosh", std::acosh},
-    {"atanh", std::atanh},
-    {"asech",
-     [](mlp::Constant const val) -> mlp::Constant {
-         return std::acosh(1 / val);
-     }},
-    {"acsch",
-     [](mlp::Constant const val) -> mlp::Constant {
-         return std::asinh(1 / val);
-     }},
-    {"acoth",
-     [](mlp::Constant const val) -> mlp::Constant {
-         return std::atanh(1 / val);
-     }},
-    {"ln", std::log},
-    {"abs", std::abs}
+    Builtin{
+        "sin", 1,
+        [](auto const val) { return std::sin(val); },
+        mlp::kernels::sin, mlp::kernels::sin,
+        "cos({0})", "-cos({0})", "asin"
+    },
+    Builtin{
+        "sinh", 1,
+        [](auto const val) { return std::sinh(val); },
+        mlp::kernels::sinh, mlp::kernels::sinh,
+        "cosh({0})", "cosh({0})", "asinh"
+    },
+    Builtin{
+        "tan", 1,
+        [](auto const val) { return std::tan(val); },
+        mlp::kernels::tan, mlp::kernels::tan,
+        "sec({0})^2", "ln(abs(sec({0})))", "atan"
+    },
+    Builtin{
+        "tanh", 1,
+        [](auto const val) { return std::tanh(val); },
+        mlp::kernels::tanh, mlp::kernels::tanh,
+        "sech({0})^2", "ln(cosh({0}))", "atanh"
+    }
 };
 
-std::map<
-    std::string,
-    std::function<mlp::Token(std::vector<mlp::Token> const &)>> const
-    k_builtin_functions =
-        k_functions |
-        std::views::transform(
-            [](std::pair<
-                std::string, std::function<mlp::Constant(mlp::Constant)>> const
-                   &pair)
-                -> std::pair<
-                    std::string,
-                    std::function<
-                        mlp::Token(std::vector<mlp::Token> const &)>> {
-                auto const &[name, definition] = pair;
-                return {
-                    name,
-                    [&definition](std::vector<mlp::Token> const &parameters)
-                        -> mlp::Token {
-                        if (parameters.size() != 1 ||
-                            !std::holds_alternative<mlp::Constant>(parameters[0]
-                            ))
-                            throw std::runtime_error{"Invalid parameters!"};
-
-                        return definition(
-                            std::get<mlp::Constant>(parameters[0])
-                        );
-                    }
-                };
+static_assert(std::ranges::is_sorted(k_builtins, {}, &Builtin::name));
+
+constexpr std::size_t k_slots = 128;
+
+constexpr std::uint32_t hash(std::string_view const name, std::uint32_t seed) {
+    for (char const c : name)
+        seed = (seed ^ static_cast<unsigned char>(c)) * 16777619;
+
+    return seed;
+}
+
+constexpr std::uint32_t k_seed = [] {
+    for (std::uint32_t seed = 2166136261;; ++seed) {
+        std::array<bool, k_slots> used{};
+
+        bool const unique = std::ranges::all_of(
+            k_builtins,
+            [&used, seed](Builtin const &builtin) -> bool {
+                return !std::exchange(
+                    used[hash(builtin.name, seed) % k_slots], true
+                );
             }
-        ) |
-        std::ranges::to<std::map>();
-
-std::map<
-    std::string, std::function<mlp::Token(std::vector<mlp::Token> const &)>>
-    k_custom_functions;
-
-std::map<std::string, std::string> k_inverses{
-    {"sin", "asin"},   {"cos", "acos"},   {"tan", "atan"},   {"sec", "asec"},
-    {"csc", "acsc"},   {"cot", "acot"},   {"sinh", "asinh"}, {"cosh", "acosh"},
-    {"tanh", "atanh"}, {"sech", "asech"}, {"csch", "acsch"}, {"coth", "acoth"},
-    {"asin", "sin"},   {"acos", "cos"},   {"atan", "tan"},   {"asec", "sec"},
-    {"acsc", "csc"},   {"acot", "cot"},   {"asinh", "sinh"}, {"acosh", "cosh"},
-    {"atanh", "tanh"}, {"asech", "sech"}, {"acsch", "csch"}, {"acoth", "coth"}
-};
+        );
 
-std::map<std::string, std::string> k_derivative_map{
-    {"sin", "cos({0})"},
-    {"cos", "-sin({0})"},
-    {"tan", "sec({0})^2"},
-    {"sec", "sec({0})*tan({0})"},
-    {"csc", "-csc({0})*cot({0})"},
-    {"cot", "-csc({0})^2"},
-    {"sinh", "cosh({0})"},
-    {"cosh", "sinh({0})"},
-    {"tanh", "sech({0})^2"},
-    {"sech", "sech({0})*tanh({0})"},
-    {"csch", "-csch({0})*cot({0})"},
-    {"coth", "-csch({0})^2"},
-    {"asin", "1/((1 - ({0})^2)^0.5)"},
-    {"acos", "-1/((1 - ({0})^2)^0.5)"},
-    {"atan", "1/(1 + ({0})^2)"},
-    {"asec", "1/(abs({0})*(({0})^2 - 1)^0.5"},
-    {"acsc", "-1/(abs({0})*(({0})^2 - 1)^0.5"},
-    {"acot", "-1/(1 + ({0})^2)"},
-    {"asinh", "1/((1 + ({0})^2)^0.5)"},
-    {"acosh", "-1/((1 + ({0})^2)^0.5)"},
-    {"atanh", "1/(1 - ({0})^2)"},
-    {"asech", "-1/(({0})*(1 - ({0})^2)^0.5"},
-    {"acsch", "1/(abs({0})*(1 - ({0})^2)^0.5"},
-    {"acoth", "1/(1 - ({0})^2)"},
-    {"ln", "1/({0})"},
-    {"abs", "abs({0})/({0})"}
-};
+        if (unique)
+            return seed;
+    }
+}();
 
-std::map<std::string, std::string> k_integral_map{
-    {"sin", "-cos({0})"},
-    {"cos", "sin({0})"},
-    {"tan", "ln(abs(sec({0})))"},
-    {"sec", "ln(abs(sec({0}) + tan({0})))"},
-    {"csc", "ln(abs(sin({0})))"},
-    {"cot", "ln(abs(csc({0}) - cot({0})))"},
-    {"sinh", "cosh({0})"},
-    {"cosh", "sinh({0})"},
-    {"tanh", "ln(cosh({0}))"},
-    {"sech", "atan(sinh({0}))"},
-    {"csch", "ln(abs(coth({0}) - csch({0})))"},
-    {"coth", "ln(abs(sinh({0})))"},
-    {"asin", "({0})asin({0}) + ((1 - ({0})^2)^0.5"},
-    {"acos", "({0})acos({0}) - ((1 - ({0})^2)^0.5"},
-    {"atan", "({0})atan({0}) - ln(abs(1 + ({0})^2))/2"},
-    {"asec", "({0})asec({0}) - acosh(abs({0}))"},
-    {"acsc", "({0})acsc({0}) + acosh(abs({0}))"},
-    {"acot", "({0})acot({0}) + ln(abs(1 + ({0})^2))/2"},
-    {"asinh", "({0})asinh({0}) - ((1 + ({0})^2)^0.5"},
-    {"acosh", "({0})acosh({0}) - ((1 - ({0})^2)^0.5"},
-    {"atanh", "({0})atanh({0}) + ln(1 - ({0})^2)/2"},
-    {"asech", "({0})asech({0}) - 2atan(((1 - ({0})/(1 - ({0}))))^0.5)"},
-    {"acsch", "({0})acsch({0}) + acoth((1 + ({0})^2)^0.5)/({0})"},
-    {"acoth", "({0})acoth({0}) + ln(({0})^2 - 1)/2"},
-    {"ln", "({0})ln(abs({0})) - ({0})"},
-    {"abs", "({0})abs({0})/2"}
-};
+constexpr auto k_slot_table = [] {
+    std::array<std::uint8_t, k_slots> table{};
+    table.fill(k_builtins.size());
+
+    for (std::size_t i = 0; i < k_builtins.size(); ++i)
+        table[hash(k_builtins[i].name, k_seed) % k_slots] = i;
+
+    return table;
+}();
+
+constexpr Builtin const *find_builtin(std::string_view const name) {
+    std::uint8_t const index = k_slot_table[hash(name, k_seed) % k_slots];
+
+    if (index == k_builtins.size() || k_builtins[index].name != name)
+        return nullptr;
+
+    return &k_builtins[index];
+}
+
+constexpr auto k_builtin_names = [] {
+    std::array<std::string_view, k_builtins.size()> names;
+
+    for (std::size_t i = 0; i < k_builtins.size(); ++i)
+        names[i] = k_builtins[i].name;
+
+    return names;
+}();
+
+static_assert(find_builtin("sin") == &k_builtins[22]);
+static_assert(!find_builtin("sine"));
 } // namespace
 
 mlp::Function::Function(std::string function, std::vector<Token> parameters) {
@@ -185,42 +293,139 @@ void mlp::Function::define(
     std::string const &name,
     std::function<Token(std::vector<Token> const &)> definition
 ) {
-    if (k_builtin_functions.contains(name))
-        throw std::runtime_error{"Cannot redefine built-in functions!"};
+    Context::current().define(name, std::move(definition));
+}
 
-    k_custom_functions[name] = std::move(definition);
+void mlp::Function::define(
+    std::string const &name, std::vector<Variable> parameters,
+    Token const &body
+) {
+    Context::current().define(name, std::move(parameters), body);
 }
 
-void mlp::Function::undef(std::string const &name) {
-    if (k_builtin_functions.contains(name))
-        throw std::runtime_error{"Cannot undefine built-in functions!"};
+std::tuple<std::string, std::vector<mlp::Variable>, mlp::Token>
+mlp::parse_definition(std::string const &definition) {
+    std::size_t const open = definition.find('(');
+    std::size_t const close = definition.find(')');
+    std::size_t const separator = definition.find('=');
+
+    if (open == std::string::npos || close == std::string::npos ||
+        separator == std::string::npos || open > close || close > separator)
+        throw std::runtime_error{"Invalid function definition!"};
 
-    k_custom_functions.erase(name);
+    std::string name = definition.substr(0, open);
+    std::erase(name, ' ');
+
+    if (name.empty() ||
+        !std::ranges::all_of(name, [](unsigned char const c) {
+            return isalpha(c);
+        }))
+        throw std::runtime_error{"Invalid function definition!"};
+
+    std::vector<Variable> parameters;
+
+    for (auto parameter : definition.substr(open + 1, close - open - 1) |
+                              std::views::split(',') |
+                              std::ranges::to<std::vector<std::string>>()) {
+        std::erase(parameter, ' ');
+
+        if (parameter.size() != 1 ||
+            !isalpha(static_cast<unsigned char>(parameter[0])))
+            throw std::runtime_error{"Invalid function definition!"};
+
+        parameters.emplace_back(parameter[0]);
+    }
+
+    count(Counter::function_tokenise);
+
+    return {
+        std::move(name), std::move(parameters),
+        tokenise(definition.substr(separator + 1))
+    };
+}
+
+void mlp::Function::define(std::string const &definition) {
+    auto [name, parameters, body] = parse_definition(definition);
+
+    define(name, std::move(parameters), body);
+}
+
+void mlp::Function::undef(std::string const &name) {
+    Context::current().undef(name);
 }
 
 bool mlp::Function::is_defined(std::string const &name) {
-    return k_builtin_functions.contains(name) ||
-           k_custom_functions.contains(name);
+    return find_builtin(name) || Context::current().is_defined(name);
 }
 
 mlp::Function::operator std::string() const {
-    std::stringstream result;
+    Sink sink;
+    this->write(sink);
 
-    result << this->function << '(';
+    return std::move(sink).str();
+}
+
+void mlp::Function::write(Sink &sink) const {
+    sink << this->function << '(';
 
     for (Token const &token :
          this->parameters | std::views::take(this->parameters.size() - 1))
-        result << token << ", ";
+        sink << token << ", ";
 
-    result << this->parameters.back() << ')';
-
-    return result.str();
+    sink << this->parameters.back() << ')';
 }
 
 bool mlp::Function::operator==(Function const &rhs) const {
     return this->function == rhs.function && this->parameters == rhs.parameters;
 }
 
+std::optional<std::uint32_t> mlp::builtin_id(std::string_view const name) {
+    Builtin const *builtin = find_builtin(name);
+
+    if (!builtin)
+        return std::nullopt;
+
+    return builtin - k_builtins.data();
+}
+
+std::span<std::string_view const> mlp::builtin_names() {
+    return k_builtin_names;
+}
+
+float mlp::call_builtin(std::uint32_t const id, float const value) {
+    return k_builtins.at(id).single(value);
+}
+
+mlp::Constant mlp::call_builtin(std::uint32_t const id, Constant const value) {
+    return k_builtins.at(id).kernel(value);
+}
+
+long double
+mlp::call_builtin(std::uint32_t const id, long double const value) {
+    return k_builtins.at(id).extended(value);
+}
+
+void mlp::call_builtin(
+    std::uint32_t const id, std::span<float const> const values,
+    std::span<float> const results
+) {
+    k_builtins.at(id).narrow(values, results);
+}
+
+void mlp::call_builtin(
+    std::uint32_t const id, std::span<Constant const> const values,
+    std::span<Constant> const results
+) {
+    k_builtins.at(id).batch(values, results);
+}
+
+void mlp::call_builtin(
+    std::uint32_t const id, std::span<long double const> const values,
+    std::span<long double> const results
+) {
+    std::ranges::transform(values, results.begin(), k_builtins.at(id).extended);
+}
+
 mlp::FunctionFactory::FunctionFactory(std::string function)
     : function(std::move(function)) {}
 
@@ -493,6 +698,18 @@ bool is_dependent_on(Function const &token, Variable const variable) {
 bool is_linear_of(Function const &, Variable) { return false; }
 
 Token evaluate(Function const &token, std::map<Variable, Token> const &values) {
+    if (Builtin const *builtin = find_builtin(token.function)) {
+        if (token.parameters.size() != builtin->arity)
+            throw std::runtime_error{"Invalid parameters!"};
+
+        Token parameter = evaluate(token.parameters[0], values);
+
+        if (!std::holds_alternative<Constant>(parameter))
+            return simplified(Function(token.function, {std::move(parameter)}));
+
+        return builtin->kernel(std::get<Constant>(parameter));
+    }
+
     auto const parameters =
         token.parameters |
         std::views::transform([&values](Token const &t) -> Token {
@@ -500,32 +717,62 @@ Token evaluate(Function const &token, std::map<Variable, Token> const &values) {
         }) |
         std::ranges::to<std::vector>();
 
-    if (k_builtin_functions.contains(token.function))
-        return k_builtin_functions.at(token.function)(parameters);
+    if (auto body = inlined(Function(token.function, parameters)))
+        return std::move(*body);
 
-    return k_custom_functions.at(token.function)(parameters);
+    auto const registry = Context::current().snapshot();
+
+    return registry->functions.at(token.function)(parameters);
+}
+
+std::optional<Token> inlined(Function const &token) {
+    auto const registry = Context::current().snapshot();
+    auto const lambda = registry->lambdas.find(token.function);
+
+    if (lambda == registry->lambdas.end())
+        return std::nullopt;
+
+    auto const &[parameters, body] = lambda->second;
+
+    if (parameters.size() != token.parameters.size())
+        throw std::runtime_error{"Invalid parameters!"};
+
+    std::map<Variable, Token> values;
+
+    for (std::size_t i = 0; i < parameters.size(); ++i)
+        values[parameters[i]] = token.parameters[i];
+
+    return evaluate(*body, values);
 }
 
 Token simplified(Function const &token) {
-    if (!k_functions.contains(token.function))
-        return simplified(k_custom_functions.at(token.function)(token.parameters
-        ));
+    Builtin const *builtin = find_builtin(token.function);
+
+    if (!builtin) {
+        if (auto const body = inlined(token))
+            return simplified(*body);
+
+        auto const registry = Context::current().snapshot();
 
-    auto parameters = token.parameters |
-                      std::views::transform([](Token const &t) -> Token {
-                          return simplified(t);
-                      }) |
-                      std::ranges::to<std::vector<Token>>();
-    Token simplified = mlp::simplified(parameters[0]);
+        return simplified(
+            registry->functions.at(token.function)(token.parameters)
+        );
+    }
+
+    if (token.parameters.size() != builtin->arity)
+        throw std::runtime_error{"Invalid parameters!"};
+
+    // Every built-in takes one parameter, so it is simplified once and only
+    // wrapped in a vector when a new Function is built from it.
+    Token simplified = mlp::simplified(token.parameters[0]);
 
     if (std::holds_alternative<Function>(simplified))
         if (auto const &p = std::get<Function>(simplified);
-            k_inverses.contains(token.function) &&
-            p.function == k_inverses[token.function])
+            !builtin->inverse.empty() && p.function == builtin->inverse)
             return mlp::simplified(p.parameters[0]);
 
     if (std::holds_alternative<Constant>(simplified))
-        return k_builtin_functions.at(token.function)(parameters);
+        return builtin->kernel(std::get<Constant>(simplified));
 
     if (token.function == "ln") {
         if (std::holds_alternative<Variable>(simplified)) {
@@ -535,7 +782,8 @@ Token simplified(Function const &token) {
 
             variable.coefficient = 1;
 
-            return k_functions.at("ln")(coefficient) + "ln"_f(parameters);
+            return std::log(coefficient) +
+                   Function(token.function, {std::move(simplified)});
         }
 
         if (std::holds_alternative<Term>(simplified))
@@ -549,7 +797,7 @@ Token simplified(Function const &token) {
 
             Expression result;
 
-            result += k_functions.at("ln")(terms.coefficient);
+            result += std::log(terms.coefficient);
 
             for (Token const &t : terms.terms)
                 result += mlp::simplified("ln"_f({t}));
@@ -558,7 +806,7 @@ Token simplified(Function const &token) {
         }
     }
 
-    return Function(token.function, std::move(parameters));
+    return Function(token.function, {std::move(simplified)});
 }
 
 Token derivative(
@@ -570,20 +818,32 @@ Token derivative(
     if (!is_dependent_on(token, variable))
         return 0.0;
 
-    if (!k_functions.contains(token.function))
+    Builtin const *builtin = find_builtin(token.function);
+
+    if (!builtin) {
+        if (auto const body = inlined(token))
+            return mlp::simplified(mlp::derivative(*body, variable, order));
+
+        auto const registry = Context::current().snapshot();
+
         return mlp::simplified(
             mlp::derivative(
-                k_custom_functions.at(token.function)(token.parameters),
+                registry->functions.at(token.function)(token.parameters),
                 variable, order
             )
         );
+    }
+
+    trace::Span const span{"derivative rule", builtin->name};
 
     auto parameter = to_string(token.parameters[0]);
 
+    count(Counter::function_tokenise);
+
     Token derivative = simplified(
         tokenise(
             std::vformat(
-                k_derivative_map.at(token.function),
+                builtin->derivative,
                 std::make_format_args(parameter)
             )
         ) *
@@ -600,19 +860,31 @@ Token integral(Function const &token, Variable const variable) {
     if (!is_dependent_on(token, variable))
         return variable * token;
 
-    if (!k_functions.contains(token.function))
+    Builtin const *builtin = find_builtin(token.function);
+
+    if (!builtin) {
+        if (auto const body = inlined(token))
+            return simplified(integral(*body, variable));
+
+        auto const registry = Context::current().snapshot();
+
         return simplified(integral(
-            k_custom_functions.at(token.function)(token.parameters), variable
+            registry->functions.at(token.function)(token.parameters), variable
         ));
+    }
 
     if (auto const &parameter = token.parameters[0];
         is_linear_of(parameter, variable)) {
+        trace::Span const span{"integral rule", builtin->name};
+
         auto string = to_string(parameter);
 
+        count(Counter::function_tokenise);
+
         return simplified(
             tokenise(
                 std::vformat(
-                    k_integral_map.at(token.function),
+                    builtin->integral,
                     std::make_format_args(string)
                 )
             ) *
@@ -0,0 +1,240 @@
+#include "../include/generator.h"
+
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/sink.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+#include "../include/variable.h"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <string_view>
+
+namespace {
+constexpr std::string_view k_variables = "xyzwuvtsrqpnmlkjhgfdcba";
+
+constexpr std::array<mlp::Constant, 8> k_constants{
+    1, 2, 3, 4, 5, 0.5, 1.5, 2.5
+};
+
+constexpr std::array<mlp::Constant, 4> k_exponents{2, 3, 4, 0.5};
+
+struct TokenBuilder final {
+    using value_type = mlp::Token;
+
+    static value_type constant(mlp::Constant const value) { return value; }
+
+    static value_type variable(char const var) { return mlp::Variable{var}; }
+
+    static value_type
+    sum(std::vector<std::pair<mlp::Sign, value_type>> const &operands) {
+        mlp::Expression result;
+
+        for (auto const &[sign, operand] : operands)
+            result.add_token(sign, operand);
+
+        return result;
+    }
+
+    static value_type product(std::vector<value_type> operands) {
+        mlp::Terms result;
+
+        for (value_type &operand : operands)
+            result *= std::move(operand);
+
+        return result;
+    }
+
+    static value_type quotient(value_type const &lhs, value_type const &rhs) {
+        return lhs / rhs;
+    }
+
+    static value_type power(value_type base, mlp::Constant const exponent) {
+        return mlp::Term{std::move(base), exponent};
+    }
+
+    static value_type call(std::string const &name, value_type argument) {
+        return mlp::Function{name, {std::move(argument)}};
+    }
+};
+
+struct TextBuilder final {
+    using value_type = std::string;
+
+    static value_type constant(mlp::Constant const value) {
+        mlp::Sink sink;
+        sink << value;
+
+        return std::move(sink).str();
+    }
+
+    static value_type variable(char const var) { return {var}; }
+
+    static value_type
+    sum(std::vector<std::pair<mlp::Sign, value_type>> const &operands) {
+        std::string result{'('};
+
+        for (auto const &[sign, operand] : operands) {
+            if (result.size() > 1)
+                result += sign == mlp::Sign::pos ? " + " : " - ";
+
+            result += operand;
+        }
+
+        return result + ')';
+    }
+
+    static value_type product(std::vector<value_type> const &operands) {
+        std::string result{'('};
+
+        for (value_type const &operand : operands) {
+            if (result.size() > 1)
+                result += '*';
+
+            result += operand;
+        }
+
+        return result + ')';
+    }
+
+    static value_type quotient(value_type const &lhs, value_type const &rhs) {
+        return '(' + lhs + ")/(" + rhs + ')';
+    }
+
+    static value_type power(value_type const &base, mlp::Constant exponent) {
+        return '(' + base + ")^" + constant(exponent);
+    }
+
+    static value_type
+    call(std::string const &name, value_type const &argument) {
+        return name + '(' + argument + ')';
+    }
+};
+} // namespace
+
+mlp::Generator::Generator(std::uint64_t const seed, GeneratorOptions options)
+    : engine(seed), options(std::move(options)) {
+    if (this->options.functions.empty())
+        for (std::string_view const name : builtin_names())
+            this->options.functions.emplace_back(name);
+
+    if (!std::ranges::all_of(this->options.functions, Function::is_defined))
+        throw std::runtime_error{"Undefined function!"};
+
+    this->options.variables = std::clamp<std::uint32_t>(
+        this->options.variables, 1, k_variables.size()
+    );
+    this->options.breadth = std::max<std::uint32_t>(this->options.breadth, 2);
+}
+
+std::uint64_t mlp::Generator::below(std::uint64_t const bound) {
+    return static_cast<std::uint64_t>(
+        static_cast<unsigned __int128>(this->engine()) * bound >> 64
+    );
+}
+
+template <typename Builder>
+auto mlp::Generator::generate(Builder &builder, std::uint32_t const depth) ->
+    typename Builder::value_type {
+    enum class Operation { leaf, add, mul, div, pow, call };
+
+    std::array<double, 6> weights{this->options.leaf};
+
+    if (depth)
+        weights = {
+            this->options.leaf, this->options.add, this->options.mul,
+            this->options.div,  this->options.pow, this->options.call
+        };
+
+    double const total = std::accumulate(weights.begin(), weights.end(), 0.0);
+    double choice =
+        static_cast<double>(this->engine() >> 11) * 0x1p-53 * total;
+
+    auto operation = Operation::leaf;
+
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+        if (choice < weights[i]) {
+            operation = static_cast<Operation>(i);
+
+            break;
+        }
+
+        choice -= weights[i];
+    }
+
+    auto const operands = [this] {
+        return 2 + this->below(this->options.breadth - 1);
+    };
+
+    switch (operation) {
+    case Operation::leaf:
+        if (this->below(3) == 0)
+            return builder.constant(
+                k_constants[this->below(k_constants.size())]
+            );
+
+        return builder.variable(
+            k_variables[this->below(this->options.variables)]
+        );
+
+    case Operation::add: {
+        std::vector<std::pair<Sign, typename Builder::value_type>> terms;
+
+        for (std::uint64_t i = operands(); i; --i) {
+            Sign const sign =
+                terms.empty() || this->below(2) ? Sign::pos : Sign::neg;
+
+            terms.emplace_back(sign, this->generate(builder, depth - 1));
+        }
+
+        return builder.sum(terms);
+    }
+
+    case Operation::mul: {
+        std::vector<typename Builder::value_type> factors;
+
+        for (std::uint64_t i = operands(); i; --i)
+            factors.push_back(this->generate(builder, depth - 1));
+
+        return builder.product(std::move(factors));
+    }
+
+    case Operation::div: {
+        auto lhs = this->generate(builder, depth - 1);
+        auto rhs = this->generate(builder, depth - 1);
+
+        return builder.quotient(lhs, rhs);
+    }
+
+    case Operation::pow: {
+        auto base = this->generate(builder, depth - 1);
+
+        return builder.power(
+            std::move(base), k_exponents[this->below(k_exponents.size())]
+        );
+    }
+
+    case Operation::call: {
+        auto const index = this->below(this->options.functions.size());
+        std::string const &name = this->options.functions[index];
+
+        return builder.call(name, this->generate(builder, depth - 1));
+    }
+    }
+
+    return builder.constant(0);
+}
+
+mlp::Token mlp::Generator::token() {
+    TokenBuilder builder;
+
+    return this->generate(builder, this->options.depth);
+}
+
+std::string mlp::Generator::text() {
+    TextBuilder builder;
+
+    return this->generate(builder, this->options.depth);
+}
@@ -0,0 +1,930 @@
+#include "../include/kernels.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#if defined(__x86_64__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define MLP_TARGET_CLONES                                                      \
+    __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default")))
+#endif
+#endif
+
+#ifndef MLP_TARGET_CLONES
+#define MLP_TARGET_CLONES
+#endif
+
+namespace {
+using mlp::Constant;
+
+constexpr Constant k_shift = 0x1.8p52;
+constexpr std::uint64_t k_shift_bits = 0x4338000000000000;
+
+constexpr Constant k_ln2_hi = 6.93147180369123816490e-01;
+constexpr Constant k_ln2_lo = 1.90821492927058770002e-10;
+constexpr Constant k_log2e = 1.44269504088896338700e+00;
+
+constexpr Constant k_pio2_1 = 1.57079632673412561417e+00;
+constexpr Constant k_pio2_2 = 6.07710050630396597660e-11;
+constexpr Constant k_pio2_3 = 2.02226624871116645580e-21;
+constexpr Constant k_invpio2 = 6.36619772367581382433e-01;
+
+constexpr Constant k_pio2 = 1.57079632679489655800e+00;
+constexpr Constant k_pio4 = 7.85398163397448278999e-01;
+constexpr Constant k_morebits = 6.123233995736765886130e-17;
+
+[[gnu::always_inline]] inline Constant exp_fast(Constant const x) {
+    Constant const n = (x * k_log2e + k_shift) - k_shift;
+    Constant const r = (x - n * k_ln2_hi) - n * k_ln2_lo;
+    Constant const t = r * r;
+
+    Constant const c =
+        r - t * (1.66666666666666019037e-01 +
+                 t * (-2.77777777770155933842e-03 +
+                      t * (6.61375632143793436117e-05 +
+                           t * (-1.65339022054652515390e-06 +
+                                t * 4.13813679705723846039e-08))));
+
+    Constant const y = 1 - ((r * c) / (c - 2) - r);
+
+    std::uint64_t const k = std::bit_cast<std::uint64_t>(n + k_shift) -
+                            k_shift_bits;
+
+    return std::bit_cast<Constant>(std::bit_cast<std::uint64_t>(y) + (k << 52));
+}
+
+[[gnu::always_inline]] inline Constant log_fast(Constant const x) {
+    std::uint64_t const bits = std::bit_cast<std::uint64_t>(x);
+    std::uint64_t const exponent = bits >> 52;
+
+    Constant m = std::bit_cast<Constant>(
+        (bits & 0x000FFFFFFFFFFFFF) | 0x3FF0000000000000
+    );
+
+    bool const high = m > 1.41421356237309504880;
+    m = high ? m * 0.5 : m;
+
+    Constant const e =
+        std::bit_cast<Constant>(0x4330000000000000 | (exponent + high)) -
+        (0x1p52 + 1023);
+
+    Constant const f = m - 1;
+    Constant const s = f / (2 + f);
+    Constant const z = s * s;
+
+    Constant const r =
+        z * (6.666666666666735130e-01 +
+             z * (3.999999999940941908e-01 +
+                  z * (2.857142874366239149e-01 +
+                       z * (2.222219843214978396e-01 +
+                            z * (1.818357216161805012e-01 +
+                                 z * (1.531383769920937332e-01 +
+                                      z * 1.479819860511658591e-01))))));
+
+    Constant const hfsq = 0.5 * f * f;
+
+    return e * k_ln2_hi - ((hfsq - (s * (hfsq + r) + e * k_ln2_lo)) - f);
+}
+
+[[gnu::always_inline]] inline Constant sin_poly(Constant const x) {
+    Constant const z = x * x;
+    Constant const w = z * z;
+
+    Constant const r =
+        8.33333333332248946124e-03 +
+        z * (-1.98412698298579493134e-04 + z * 2.75573137070700676789e-06) +
+        z * w * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10);
+
+    return x + z * x * (-1.66666666666666324348e-01 + z * r);
+}
+
+[[gnu::always_inline]] inline Constant cos_poly(Constant const x) {
+    Constant const z = x * x;
+    Constant const w = z * z;
+
+    Constant const r =
+        z * (4.16666666666666019037e-02 +
+             z * (-1.38888888888741095749e-03 + z * 2.48015872894767294178e-05)
+            ) +
+        w * w *
+            (-2.75573143513906633035e-07 +
+             z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)
+            );
+
+    Constant const hz = 0.5 * z;
+    Constant const v = 1 - hz;
+
+    return v + (((1 - v) - hz) + z * r);
+}
+
+template <typename T> struct SinCos final {
+    T sin;
+    T cos;
+};
+
+[[gnu::always_inline]] inline SinCos<Constant> sincos_fast(Constant const x) {
+    Constant const n = (x * k_invpio2 + k_shift) - k_shift;
+    Constant const r = ((x - n * k_pio2_1) - n * k_pio2_2) - n * k_pio2_3;
+
+    std::uint64_t const quadrant = std::bit_cast<std::uint64_t>(n + k_shift);
+
+    Constant const s = sin_poly(r);
+    Constant const c = cos_poly(r);
+
+    Constant const sin = quadrant & 1 ? c : s;
+    Constant const cos = quadrant & 1 ? s : c;
+
+    return {
+        quadrant & 2 ? -sin : sin, (quadrant + 1) & 2 ? -cos : cos
+    };
+}
+
+[[gnu::always_inline]] inline Constant atan_fast(Constant const x) {
+    Constant const a = std::fabs(x);
+
+    bool const high = a > 2.41421356237309504880;
+    bool const middle = !high && a > 0.66;
+
+    Constant const t = high ? -1 / a : middle ? (a - 1) / (a + 1) : a;
+    Constant const offset = high ? k_pio2 + k_morebits
+                            : middle ? k_pio4 + 0.5 * k_morebits
+                                     : 0;
+
+    Constant const z = t * t;
+
+    Constant const p =
+        z *
+        ((((-8.750608600031904122785e-01 * z - 1.615753718733365076637e+01) *
+               z -
+           7.500855792314704667340e+01) *
+              z -
+          1.228866684490136173410e+02) *
+             z -
+         6.485021904942025371773e+01) /
+        (((((z + 2.485846490142306297962e+01) * z +
+            1.650270098316988542046e+02) *
+               z +
+           4.328810604912902668951e+02) *
+              z +
+          4.853903996359136964868e+02) *
+             z +
+         1.945506571482613964425e+02);
+
+    return std::copysign(offset + (t * p + t), x);
+}
+
+constexpr float k_shift_single = 0x1.8p23f;
+constexpr std::uint32_t k_shift_single_bits = 0x4B400000;
+
+constexpr float k_ln2_hi_single = 6.93359375e-01f;
+constexpr float k_ln2_lo_single = -2.12194440e-04f;
+constexpr float k_log2e_single = 1.44269504e+00f;
+
+constexpr float k_pio2_1_single = 1.5703125f;
+constexpr float k_pio2_2_single = 4.837512969970703125e-04f;
+constexpr float k_pio2_3_single = 7.54971551941707730293e-08f;
+constexpr float k_pio2_4_single = 7.443547731314504e-13f;
+constexpr float k_invpio2_single = 6.36619772e-01f;
+
+// The single-precision versions follow the Cephes expf, logf, sinf, cosf
+// and atanf polynomials. The reduction by pi/2 splits it four ways so that
+// n * k_pio2_{1,2,3}_single is exact for every n in the fast range.
+[[gnu::always_inline]] inline float exp_fast(float const x) {
+    float const n = (x * k_log2e_single + k_shift_single) - k_shift_single;
+    float const r = (x - n * k_ln2_hi_single) - n * k_ln2_lo_single;
+
+    float const p =
+        5.0000001201e-01f +
+        r * (1.6666665459e-01f +
+             r * (4.1665795894e-02f +
+                  r * (8.3334519073e-03f +
+                       r * (1.3981999507e-03f + r * 1.9875691500e-04f))));
+
+    float const y = p * r * r + r + 1;
+
+    std::uint32_t const k = std::bit_cast<std::uint32_t>(n + k_shift_single) -
+                            k_shift_single_bits;
+
+    return std::bit_cast<float>(std::bit_cast<std::uint32_t>(y) + (k << 23));
+}
+
+[[gnu::always_inline]] inline float log_fast(float const x) {
+    std::uint32_t const bits = std::bit_cast<std::uint32_t>(x);
+    std::uint32_t const exponent = bits >> 23;
+
+    float m = std::bit_cast<float>((bits & 0x007FFFFF) | 0x3F800000);
+
+    bool const high = m > 1.41421356f;
+    m = high ? m * 0.5f : m;
+
+    float const e =
+        std::bit_cast<float>(0x4B000000 | (exponent + high)) - (0x1p23f + 127);
+
+    float const f = m - 1;
+    float const z = f * f;
+
+    float const r =
+        3.3333331174e-01f +
+        f * (-2.4999993993e-01f +
+             f * (2.0000714765e-01f +
+                  f * (-1.6668057665e-01f +
+                       f * (1.4249322787e-01f +
+                            f * (-1.2420140846e-01f +
+                                 f * (1.1676998740e-01f +
+                                      f * (-1.1514610310e-01f +
+                                           f * 7.0376836292e-02f)))))));
+
+    return f + ((f * z * r + e * k_ln2_lo_single) - 0.5f * z) +
+           e * k_ln2_hi_single;
+}
+
+[[gnu::always_inline]] inline SinCos<float> sincos_fast(float const x) {
+    float const n = (x * k_invpio2_single + k_shift_single) - k_shift_single;
+    float const r = (((x - n * k_pio2_1_single) - n * k_pio2_2_single) -
+                     n * k_pio2_3_single) -
+                    n * k_pio2_4_single;
+
+    std::uint32_t const quadrant =
+        std::bit_cast<std::uint32_t>(n + k_shift_single);
+
+    float const z = r * r;
+
+    float const s =
+        r + r * z *
+                (-1.6666654611e-01f +
+                 z * (8.3321608736e-03f + z * -1.9515295891e-04f));
+    float const c =
+        1 - 0.5f * z +
+        z * z *
+            (4.166664568298827e-02f +
+             z * (-1.388731625493765e-03f + z * 2.443315711809948e-05f));
+
+    float const sin = quadrant & 1 ? c : s;
+    float const cos = quadrant & 1 ? s : c;
+
+    return {
+        quadrant & 2 ? -sin : sin, (quadrant + 1) & 2 ? -cos : cos
+    };
+}
+
+[[gnu::always_inline]] inline float atan_fast(float const x) {
+    float const a = std::fabs(x);
+
+    bool const high = a > 2.41421356f;
+    bool const middle = !high && a > 0.414213562f;
+
+    float const t = high ? -1 / a : middle ? (a - 1) / (a + 1) : a;
+    float const offset = high     ? 1.57079633f
+                         : middle ? 0.785398163f
+                                  : 0;
+
+    float const z = t * t;
+
+    float const p =
+        z * (-3.33329491539e-01f +
+             z * (1.99777106478e-01f +
+                  z * (-1.38776856032e-01f + z * 8.05374449538e-02f)));
+
+    return std::copysign(offset + (t * p + t), x);
+}
+
+// Where the fast paths of each precision stay accurate.
+template <typename T> struct Limits;
+
+template <> struct Limits<Constant> final {
+    static constexpr Constant trigonometric = 1e5;
+    static constexpr Constant exponential = 708;
+    static constexpr Constant normal = 0x1p-1022;
+    static constexpr Constant large = 0x1p500;
+    static constexpr Constant small = 0x1p-500;
+};
+
+template <> struct Limits<float> final {
+    static constexpr float trigonometric = 256;
+    static constexpr float exponential = 86;
+    static constexpr float normal = 0x1p-126f;
+    static constexpr float large = 0x1p60f;
+    static constexpr float small = 0x1p-60f;
+};
+
+template <typename T>
+[[gnu::always_inline]] inline T log1p_fast(T const x) {
+    T const u = 1 + x;
+    T const d = u - 1;
+
+    return d == 0 ? x : log_fast(u) * (x / d);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline T expm1_fast(T const x) {
+    T const u = exp_fast(x);
+    T const d = u - 1;
+
+    if (u == 1)
+        return x;
+
+    return d == -1 ? -1 : d * (x / log_fast(u));
+}
+
+template <auto fast, auto in_range, auto fallback, typename T>
+[[gnu::always_inline]] inline void
+map(std::span<T const> const x, std::span<T> const y) {
+    constexpr std::size_t block = 256;
+
+    std::size_t const size = std::min(x.size(), y.size());
+    T const *input = x.data();
+    T *output = y.data();
+
+    std::array<T, block> buffer;
+
+    for (std::size_t begin = 0; begin < size; begin += block) {
+        std::size_t const width = std::min(block, size - begin);
+
+        for (std::size_t i = 0; i < width; ++i)
+            buffer[i] = fast(input[begin + i]);
+
+        for (std::size_t i = 0; i < width; ++i) {
+            T const value = input[begin + i];
+
+            output[begin + i] = in_range(value) ? buffer[i] : fallback(value);
+        }
+    }
+}
+
+constexpr auto k_finite = []<typename T>(T const x) -> bool {
+    return std::fabs(x) < std::numeric_limits<T>::infinity();
+};
+
+constexpr auto k_trigonometric = []<typename T>(T const x) -> bool {
+    return std::fabs(x) < Limits<T>::trigonometric;
+};
+
+constexpr auto k_reciprocal_trigonometric = []<typename T>(T const x) -> bool {
+    return std::fabs(x) < Limits<T>::trigonometric && x != 0;
+};
+
+constexpr auto k_exponential = []<typename T>(T const x) -> bool {
+    return std::fabs(x) < Limits<T>::exponential;
+};
+
+constexpr auto k_reciprocal_exponential = []<typename T>(T const x) -> bool {
+    return std::fabs(x) < Limits<T>::exponential && x != 0;
+};
+
+constexpr auto k_normal = []<typename T>(T const x) -> bool {
+    return x >= Limits<T>::normal && x < std::numeric_limits<T>::infinity();
+};
+
+constexpr auto k_unit = [](auto const x) -> bool { return std::fabs(x) < 1; };
+
+constexpr auto k_outside_unit = []<typename T>(T const x) -> bool {
+    return std::fabs(x) > 1 &&
+           std::fabs(x) < std::numeric_limits<T>::infinity();
+};
+
+constexpr auto k_large = []<typename T>(T const x) -> bool {
+    return std::fabs(x) < Limits<T>::large;
+};
+
+constexpr auto k_reciprocal_large = []<typename T>(T const x) -> bool {
+    return std::fabs(x) > Limits<T>::small &&
+           std::fabs(x) < std::numeric_limits<T>::infinity();
+};
+
+constexpr auto k_acosh = []<typename T>(T const x) -> bool {
+    return x >= 1 && x < Limits<T>::large;
+};
+
+constexpr auto k_asech = []<typename T>(T const x) -> bool {
+    return x > Limits<T>::small && x <= 1;
+};
+
+template <typename T>
+[[gnu::always_inline]] inline T sinh_fast(T const x) {
+    T const a = std::fabs(x);
+    T const e = expm1_fast(a);
+    T const h = a < 22 ? T{0.5} * (e + e / (e + 1)) : T{0.5} * exp_fast(a);
+
+    return std::copysign(h, x);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline T cosh_fast(T const x) {
+    T const e = exp_fast(std::fabs(x));
+
+    return T{0.5} * e + T{0.5} / e;
+}
+
+template <typename T>
+[[gnu::always_inline]] inline T tanh_fast(T const x) {
+    T const a = std::fabs(x);
+    T const e = expm1_fast(2 * std::min(a, T{22}));
+
+    return std::copysign(a < 22 ? e / (e + 2) : 1, x);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline T asin_fast(T const x) {
+    return atan_fast(x / std::sqrt((1 - x) * (1 + x)));
+}
+
+template <typename T>
+[[gnu::always_inline]] inline T acos_fast(T const x) {
+    return 2 * atan_fast(std::sqrt((1 - x) / (1 + x)));
+}
+
+template <typename T>
+[[gnu::always_inline]] inline T asinh_fast(T const x) {
+    T const a = std::fabs(x);
+    T const a2 = a * a;
+
+    return std::copysign(log1p_fast(a + a2 / (1 + std::sqrt(1 + a2))), x);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline T acosh_fast(T const x) {
+    T const t = x - 1;
+
+    return log1p_fast(t + std::sqrt(2 * t + t * t));
+}
+
+template <typename T>
+[[gnu::always_inline]] inline T atanh_fast(T const x) {
+    T const a = std::fabs(x);
+
+    return std::copysign(T{0.5} * log1p_fast(2 * a / (1 - a)), x);
+}
+
+namespace batch {
+template <typename T>
+[[gnu::always_inline]] inline void
+sin(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return sincos_fast(v).sin; },
+        k_trigonometric,
+        [](auto const v) { return std::sin(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+cos(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return sincos_fast(v).cos; },
+        k_trigonometric,
+        [](auto const v) { return std::cos(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+tan(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) {
+            auto const [sin, cos] = sincos_fast(v);
+
+            return sin / cos;
+        },
+        k_trigonometric,
+        [](auto const v) { return std::tan(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+sec(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return 1 / sincos_fast(v).cos; },
+        k_trigonometric,
+        [](auto const v) { return 1 / std::cos(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+csc(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return 1 / sincos_fast(v).sin; },
+        k_reciprocal_trigonometric,
+        [](auto const v) { return 1 / std::sin(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+cot(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) {
+            auto const [sin, cos] = sincos_fast(v);
+
+            return cos / sin;
+        },
+        k_reciprocal_trigonometric,
+        [](auto const v) { return 1 / std::tan(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+sinh(std::span<T const> const x, std::span<T> const y) {
+    map<sinh_fast<T>, k_exponential,
+        [](auto const v) { return std::sinh(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+cosh(std::span<T const> const x, std::span<T> const y) {
+    map<cosh_fast<T>, k_exponential,
+        [](auto const v) { return std::cosh(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+tanh(std::span<T const> const x, std::span<T> const y) {
+    map<tanh_fast<T>, k_finite,
+        [](auto const v) { return std::tanh(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+sech(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return 1 / cosh_fast(v); },
+        k_exponential,
+        [](auto const v) { return 1 / std::cosh(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+csch(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return 1 / sinh_fast(v); },
+        k_reciprocal_exponential,
+        [](auto const v) { return 1 / std::sinh(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+coth(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return 1 / tanh_fast(v); },
+        k_reciprocal_large,
+        [](auto const v) { return 1 / std::tanh(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+asin(std::span<T const> const x, std::span<T> const y) {
+    map<asin_fast<T>, k_unit,
+        [](auto const v) { return std::asin(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+acos(std::span<T const> const x, std::span<T> const y) {
+    map<acos_fast<T>, k_unit,
+        [](auto const v) { return std::acos(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+atan(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return atan_fast(v); }, k_finite,
+        [](auto const v) { return std::atan(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+asec(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return acos_fast(1 / v); },
+        k_outside_unit,
+        [](auto const v) { return std::acos(1 / v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+acsc(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return asin_fast(1 / v); },
+        k_outside_unit,
+        [](auto const v) { return std::asin(1 / v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+acot(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return atan_fast(1 / v); },
+        k_reciprocal_large,
+        [](auto const v) { return std::atan(1 / v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+asinh(std::span<T const> const x, std::span<T> const y) {
+    map<asinh_fast<T>, k_large,
+        [](auto const v) { return std::asinh(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+acosh(std::span<T const> const x, std::span<T> const y) {
+    map<acosh_fast<T>, k_acosh,
+        [](auto const v) { return std::acosh(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+atanh(std::span<T const> const x, std::span<T> const y) {
+    map<atanh_fast<T>, k_unit,
+        [](auto const v) { return std::atanh(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+asech(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return acosh_fast(1 / v); },
+        k_asech,
+        [](auto const v) { return std::acosh(1 / v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+acsch(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return asinh_fast(1 / v); },
+        k_reciprocal_large,
+        [](auto const v) { return std::asinh(1 / v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+acoth(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return atanh_fast(1 / v); },
+        k_outside_unit,
+        [](auto const v) { return std::atanh(1 / v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+ln(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return log_fast(v); }, k_normal,
+        [](auto const v) { return std::log(v); }>(x, y);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline void
+abs(std::span<T const> const x, std::span<T> const y) {
+    map<[](auto const v) { return std::fabs(v); }, k_finite,
+        [](auto const v) { return std::fabs(v); }>(x, y);
+}
+} // namespace batch
+} // namespace
+
+namespace mlp::kernels {
+MLP_TARGET_CLONES void
+sin(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::sin(x, y);
+}
+
+MLP_TARGET_CLONES void
+sin(std::span<float const> const x, std::span<float> const y) {
+    batch::sin(x, y);
+}
+
+MLP_TARGET_CLONES void
+cos(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::cos(x, y);
+}
+
+MLP_TARGET_CLONES void
+cos(std::span<float const> const x, std::span<float> const y) {
+    batch::cos(x, y);
+}
+
+MLP_TARGET_CLONES void
+tan(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::tan(x, y);
+}
+
+MLP_TARGET_CLONES void
+tan(std::span<float const> const x, std::span<float> const y) {
+    batch::tan(x, y);
+}
+
+MLP_TARGET_CLONES void
+sec(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::sec(x, y);
+}
+
+MLP_TARGET_CLONES void
+sec(std::span<float const> const x, std::span<float> const y) {
+    batch::sec(x, y);
+}
+
+MLP_TARGET_CLONES void
+csc(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::csc(x, y);
+}
+
+MLP_TARGET_CLONES void
+csc(std::span<float const> const x, std::span<float> const y) {
+    batch::csc(x, y);
+}
+
+MLP_TARGET_CLONES void
+cot(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::cot(x, y);
+}
+
+MLP_TARGET_CLONES void
+cot(std::span<float const> const x, std::span<float> const y) {
+    batch::cot(x, y);
+}
+
+MLP_TARGET_CLONES void
+sinh(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::sinh(x, y);
+}
+
+MLP_TARGET_CLONES void
+sinh(std::span<float const> const x, std::span<float> const y) {
+    batch::sinh(x, y);
+}
+
+MLP_TARGET_CLONES void
+cosh(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::cosh(x, y);
+}
+
+MLP_TARGET_CLONES void
+cosh(std::span<float const> const x, std::span<float> const y) {
+    batch::cosh(x, y);
+}
+
+MLP_TARGET_CLONES void
+tanh(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::tanh(x, y);
+}
+
+MLP_TARGET_CLONES void
+tanh(std::span<float const> const x, std::span<float> const y) {
+    batch::tanh(x, y);
+}
+
+MLP_TARGET_CLONES void
+sech(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::sech(x, y);
+}
+
+MLP_TARGET_CLONES void
+sech(std::span<float const> const x, std::span<float> const y) {
+    batch::sech(x, y);
+}
+
+MLP_TARGET_CLONES void
+csch(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::csch(x, y);
+}
+
+MLP_TARGET_CLONES void
+csch(std::span<float const> const x, std::span<float> const y) {
+    batch::csch(x, y);
+}
+
+MLP_TARGET_CLONES void
+coth(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::coth(x, y);
+}
+
+MLP_TARGET_CLONES void
+coth(std::span<float const> const x, std::span<float> const y) {
+    batch::coth(x, y);
+}
+
+MLP_TARGET_CLONES void
+asin(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::asin(x, y);
+}
+
+MLP_TARGET_CLONES void
+asin(std::span<float const> const x, std::span<float> const y) {
+    batch::asin(x, y);
+}
+
+MLP_TARGET_CLONES void
+acos(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::acos(x, y);
+}
+
+MLP_TARGET_CLONES void
+acos(std::span<float const> const x, std::span<float> const y) {
+    batch::acos(x, y);
+}
+
+MLP_TARGET_CLONES void
+atan(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::atan(x, y);
+}
+
+MLP_TARGET_CLONES void
+atan(std::span<float const> const x, std::span<float> const y) {
+    batch::atan(x, y);
+}
+
+MLP_TARGET_CLONES void
+asec(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::asec(x, y);
+}
+
+MLP_TARGET_CLONES void
+asec(std::span<float const> const x, std::span<float> const y) {
+    batch::asec(x, y);
+}
+
+MLP_TARGET_CLONES void
+acsc(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::acsc(x, y);
+}
+
+MLP_TARGET_CLONES void
+acsc(std::span<float const> const x, std::span<float> const y) {
+    batch::acsc(x, y);
+}
+
+MLP_TARGET_CLONES void
+acot(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::acot(x, y);
+}
+
+MLP_TARGET_CLONES void
+acot(std::span<float const> const x, std::span<float> const y) {
+    batch::acot(x, y);
+}
+
+MLP_TARGET_CLONES void
+asinh(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::asinh(x, y);
+}
+
+MLP_TARGET_CLONES void
+asinh(std::span<float const> const x, std::span<float> const y) {
+    batch::asinh(x, y);
+}
+
+MLP_TARGET_CLONES void
+acosh(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::acosh(x, y);
+}
+
+MLP_TARGET_CLONES void
+acosh(std::span<float const> const x, std::span<float> const y) {
+    batch::acosh(x, y);
+}
+
+MLP_TARGET_CLONES void
+atanh(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::atanh(x, y);
+}
+
+MLP_TARGET_CLONES void
+atanh(std::span<float const> const x, std::span<float> const y) {
+    batch::atanh(x, y);
+}
+
+MLP_TARGET_CLONES void
+asech(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::asech(x, y);
+}
+
+MLP_TARGET_CLONES void
+asech(std::span<float const> const x, std::span<float> const y) {
+    batch::asech(x, y);
+}
+
+MLP_TARGET_CLONES void
+acsch(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::acsch(x, y);
+}
+
+MLP_TARGET_CLONES void
+acsch(std::span<float const> const x, std::span<float> const y) {
+    batch::acsch(x, y);
+}
+
+MLP_TARGET_CLONES void
+acoth(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::acoth(x, y);
+}
+
+MLP_TARGET_CLONES void
+acoth(std::span<float const> const x, std::span<float> const y) {
+    batch::acoth(x, y);
+}
+
+MLP_TARGET_CLONES void
+ln(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::ln(x, y);
+}
+
+MLP_TARGET_CLONES void
+ln(std::span<float const> const x, std::span<float> const y) {
+    batch::ln(x, y);
+}
+
+MLP_TARGET_CLONES void
+abs(std::span<Constant const> const x, std::span<Constant> const y) {
+    batch::abs(x, y);
+}
+
+MLP_TARGET_CLONES void
+abs(std::span<float const> const x, std::span<float> const y) {
+    batch::abs(x, y);
+}
+} // namespace mlp::kernels
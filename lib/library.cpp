@@ -0,0 +1,334 @@
+#include "../include/library.h"
+
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/serialise.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+#include "../include/variable.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+constexpr std::string_view k_magic = "MLPL";
+
+struct Header final {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t count;
+    std::uint64_t entries;
+    std::uint64_t size;
+    std::uint64_t builtins;
+};
+
+template <typename T> void put(std::string &buffer, T const &value) {
+    buffer.append(reinterpret_cast<char const *>(&value), sizeof(T));
+}
+
+void align(std::string &buffer, std::size_t const alignment) {
+    buffer.resize((buffer.size() + alignment - 1) / alignment * alignment);
+}
+
+// Call instructions store indices into the built-in table, so a library
+// records which table it was written against.
+std::uint64_t builtins_hash() {
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    auto const mix = [&hash](unsigned char const byte) {
+        hash = (hash ^ byte) * 1099511628211ULL;
+    };
+
+    for (std::string_view const name : mlp::builtin_names()) {
+        for (char const character : name)
+            mix(static_cast<unsigned char>(character));
+
+        mix(0);
+    }
+
+    return hash;
+}
+} // namespace
+
+struct mlp::Library::Entry final {
+    std::uint64_t name;
+    std::uint32_t name_size;
+    std::uint32_t inputs_size;
+    std::uint64_t inputs;
+    std::uint64_t token;
+    std::uint64_t token_size;
+    std::uint64_t code;
+    std::uint32_t code_size;
+    std::uint32_t depth;
+};
+
+mlp::Library::Library(std::filesystem::path const &path) {
+    int const file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (file < 0)
+        throw std::runtime_error{"Cannot open library!"};
+
+    struct stat status{};
+
+    if (::fstat(file, &status) < 0 ||
+        static_cast<std::size_t>(status.st_size) < sizeof(Header)) {
+        ::close(file);
+
+        throw std::runtime_error{"Not an expression library!"};
+    }
+
+    this->size = status.st_size;
+
+    void *mapping =
+        ::mmap(nullptr, this->size, PROT_READ, MAP_SHARED, file, 0);
+
+    ::close(file);
+
+    if (mapping == MAP_FAILED)
+        throw std::runtime_error{"Cannot map library!"};
+
+    this->data = static_cast<std::byte const *>(mapping);
+
+    auto const *header = reinterpret_cast<Header const *>(this->data);
+
+    if (std::string_view{header->magic, sizeof header->magic} != k_magic ||
+        header->size != this->size) {
+        ::munmap(mapping, this->size);
+
+        throw std::runtime_error{"Not an expression library!"};
+    }
+
+    if (header->version != version || header->builtins != builtins_hash()) {
+        ::munmap(mapping, this->size);
+
+        throw std::runtime_error{"Unsupported expression library version!"};
+    }
+
+    if (header->entries % alignof(Entry) ||
+        header->entries > this->size ||
+        header->count > (this->size - header->entries) / sizeof(Entry)) {
+        ::munmap(mapping, this->size);
+
+        throw std::runtime_error{"Malformed expression library!"};
+    }
+
+    this->entries =
+        reinterpret_cast<Entry const *>(this->data + header->entries);
+    this->count = header->count;
+
+    try {
+        this->verified =
+            std::make_unique<std::atomic<std::uint8_t>[]>(this->count);
+    } catch (...) {
+        ::munmap(mapping, this->size);
+
+        throw;
+    }
+}
+
+mlp::Library::Library(Library &&library) noexcept
+    : data(std::exchange(library.data, nullptr)),
+      size(std::exchange(library.size, 0)),
+      entries(std::exchange(library.entries, nullptr)),
+      count(std::exchange(library.count, 0)),
+      verified(std::move(library.verified)) {}
+
+mlp::Library &mlp::Library::operator=(Library &&library) noexcept {
+    std::swap(this->data, library.data);
+    std::swap(this->size, library.size);
+    std::swap(this->entries, library.entries);
+    std::swap(this->count, library.count);
+    std::swap(this->verified, library.verified);
+
+    return *this;
+}
+
+mlp::Library::~Library() {
+    if (this->data)
+        ::munmap(const_cast<std::byte *>(this->data), this->size);
+}
+
+void mlp::Library::write(
+    std::filesystem::path const &path,
+    std::map<std::string, Token> const &expressions
+) {
+    std::vector<Entry> entries;
+    entries.reserve(expressions.size());
+
+    std::string code;
+    std::string blobs;
+
+    for (auto const &[name, token] : expressions) {
+        Entry entry{};
+
+        entry.name = blobs.size();
+        entry.name_size = static_cast<std::uint32_t>(name.size());
+        blobs += name;
+
+        std::string const binary = serialise(token);
+        entry.token = blobs.size();
+        entry.token_size = binary.size();
+        blobs += binary;
+
+        try {
+            Program const program{token};
+            ProgramView const view = program;
+
+            entry.inputs = blobs.size();
+            entry.inputs_size = static_cast<std::uint32_t>(view.inputs.size());
+            blobs += view.inputs;
+
+            entry.code = code.size();
+            entry.code_size =
+                static_cast<std::uint32_t>(view.instructions.size());
+            entry.depth = view.depth;
+
+            for (Instruction const &instruction : view.instructions)
+                put(code, instruction);
+        } catch (std::runtime_error const &) {
+            entry.code_size = 0;
+        }
+
+        entries.push_back(entry);
+    }
+
+    std::string file(sizeof(Header), '\0');
+    align(file, alignof(Entry));
+
+    std::uint64_t const entries_offset = file.size();
+    file.resize(file.size() + entries.size() * sizeof(Entry));
+    align(file, alignof(Instruction));
+
+    std::uint64_t const code_offset = file.size();
+    file += code;
+
+    std::uint64_t const blobs_offset = file.size();
+    file += blobs;
+
+    for (Entry &entry : entries) {
+        entry.name += blobs_offset;
+        entry.inputs += blobs_offset;
+        entry.token += blobs_offset;
+        entry.code = entry.code_size ? entry.code + code_offset : 0;
+    }
+
+    std::memcpy(
+        file.data() + entries_offset, entries.data(),
+        entries.size() * sizeof(Entry)
+    );
+
+    Header header{};
+    std::ranges::copy(k_magic, header.magic);
+    header.version = version;
+    header.count = entries.size();
+    header.entries = entries_offset;
+    header.size = file.size();
+    header.builtins = builtins_hash();
+
+    std::memcpy(file.data(), &header, sizeof header);
+
+    std::ofstream output{path, std::ios::binary | std::ios::trunc};
+    output.write(file.data(), static_cast<std::streamsize>(file.size()));
+
+    if (!output)
+        throw std::runtime_error{"Cannot write library!"};
+}
+
+std::span<std::byte const>
+mlp::Library::region(std::uint64_t const offset, std::uint64_t const size)
+    const {
+    if (offset > this->size || size > this->size - offset)
+        throw std::runtime_error{"Malformed expression library!"};
+
+    return {this->data + offset, size};
+}
+
+mlp::Library::Entry const *mlp::Library::find(std::string_view const name
+) const {
+    auto const name_of = [this](Entry const &entry) -> std::string_view {
+        auto const bytes = this->region(entry.name, entry.name_size);
+
+        return {reinterpret_cast<char const *>(bytes.data()), bytes.size()};
+    };
+
+    Entry const *const end = this->entries + this->count;
+    Entry const *const entry =
+        std::ranges::lower_bound(this->entries, end, name, {}, name_of);
+
+    if (entry == end || name_of(*entry) != name)
+        return nullptr;
+
+    return entry;
+}
+
+std::size_t mlp::Library::entry_count() const { return this->count; }
+
+bool mlp::Library::contains(std::string_view const name) const {
+    return this->find(name);
+}
+
+mlp::Token mlp::Library::token(std::string_view const name) const {
+    Entry const *entry = this->find(name);
+
+    if (!entry)
+        throw std::runtime_error{"Undefined library entry!"};
+
+    Token token;
+
+    BinaryReader{this->region(entry->token, entry->token_size)} >> token;
+
+    return token;
+}
+
+std::optional<mlp::ProgramView>
+mlp::Library::program(std::string_view const name) const {
+    Entry const *entry = this->find(name);
+
+    if (!entry)
+        throw std::runtime_error{"Undefined library entry!"};
+
+    if (!entry->code_size)
+        return std::nullopt;
+
+    std::atomic<std::uint8_t> &verified =
+        this->verified[entry - this->entries];
+    std::uint8_t state = verified.load(std::memory_order_acquire);
+
+    if (!state) {
+        try {
+            state = verify(this->view(*entry)) ? 1 : 2;
+        } catch (std::runtime_error const &) {
+            state = 2;
+        }
+
+        verified.store(state, std::memory_order_release);
+    }
+
+    if (state != 1)
+        throw std::runtime_error{"Malformed expression library!"};
+
+    return this->view(*entry);
+}
+
+mlp::ProgramView mlp::Library::view(Entry const &entry) const {
+    if (entry.code % alignof(Instruction))
+        throw std::runtime_error{"Malformed expression library!"};
+
+    auto const code = this->region(
+        entry.code, std::uint64_t{entry.code_size} * sizeof(Instruction)
+    );
+    auto const inputs = this->region(entry.inputs, entry.inputs_size);
+
+    return ProgramView{
+        {reinterpret_cast<Instruction const *>(code.data()), entry.code_size},
+        {reinterpret_cast<char const *>(inputs.data()), inputs.size()},
+        entry.depth
+    };
+}
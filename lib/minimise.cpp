@@ -0,0 +1,342 @@
+#include "../include/minimise.h"
+
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+#include "../include/variable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <numeric>
+
+namespace {
+constexpr mlp::Constant k_armijo = 1e-4;
+constexpr mlp::Constant k_wolfe = 0.9;
+constexpr std::uint32_t k_attempts = 60;
+
+mlp::Constant dot(
+    std::span<mlp::Constant const> const lhs,
+    std::span<mlp::Constant const> const rhs
+) {
+    return std::inner_product(lhs.begin(), lhs.end(), rhs.begin(), 0.0);
+}
+
+// Factors the symmetric matrix in place into its lower Cholesky factor, or
+// returns false if it is not positive definite.
+bool cholesky(std::vector<mlp::Constant> &matrix, std::size_t const size) {
+    for (std::size_t j = 0; j < size; ++j) {
+        mlp::Constant diagonal = matrix[j * size + j];
+
+        for (std::size_t k = 0; k < j; ++k)
+            diagonal -= matrix[j * size + k] * matrix[j * size + k];
+
+        if (!(diagonal > 0))
+            return false;
+
+        matrix[j * size + j] = std::sqrt(diagonal);
+
+        for (std::size_t i = j + 1; i < size; ++i) {
+            mlp::Constant value = matrix[i * size + j];
+
+            for (std::size_t k = 0; k < j; ++k)
+                value -= matrix[i * size + k] * matrix[j * size + k];
+
+            matrix[i * size + j] = value / matrix[j * size + j];
+        }
+    }
+
+    return true;
+}
+
+// Solves L L^T x = b in place for the factor left by cholesky().
+void substitute(
+    std::vector<mlp::Constant> const &factor, std::size_t const size,
+    std::span<mlp::Constant> const x
+) {
+    for (std::size_t i = 0; i < size; ++i) {
+        for (std::size_t k = 0; k < i; ++k)
+            x[i] -= factor[i * size + k] * x[k];
+
+        x[i] /= factor[i * size + i];
+    }
+
+    for (std::size_t i = size; i-- > 0;) {
+        for (std::size_t k = i + 1; k < size; ++k)
+            x[i] -= factor[k * size + i] * x[k];
+
+        x[i] /= factor[i * size + i];
+    }
+}
+} // namespace
+
+mlp::Minimiser::Minimiser(
+    Token const &objective, std::vector<Variable> const &variables,
+    Descent const descent
+)
+    : descent(descent), count(variables.size()) {
+    std::vector<Token> gradient;
+    gradient.reserve(this->count);
+
+    for (Variable const &variable : variables)
+        gradient.push_back(simplified(derivative(objective, variable, 1)));
+
+    this->programs.emplace_back(objective);
+
+    for (Token const &component : gradient)
+        this->programs.emplace_back(component);
+
+    if (descent == Descent::newton)
+        for (std::size_t i = 0; i < this->count; ++i)
+            for (std::size_t j = i; j < this->count; ++j)
+                this->programs.emplace_back(
+                    simplified(derivative(gradient[i], variables[j], 1))
+                );
+
+    auto const position = [&variables](char const input) -> std::size_t {
+        return std::ranges::find(variables, Variable{input}) -
+               variables.begin();
+    };
+
+    for (char const input : this->programs.front().variables())
+        if (position(input) == variables.size())
+            this->names += input;
+
+    for (Program const &program : this->programs) {
+        auto &slots = this->slots.emplace_back();
+
+        for (char const input : program.variables()) {
+            std::size_t const index = position(input);
+
+            slots.push_back(
+                index < this->count ? index
+                                    : this->count + this->names.find(input)
+            );
+        }
+    }
+}
+
+std::string_view mlp::Minimiser::parameters() const { return this->names; }
+
+mlp::Constant mlp::Minimiser::run(
+    std::size_t const index, std::span<Constant const> const values,
+    std::vector<Column> &columns, std::vector<Constant> &scratch
+) const {
+    Constant result;
+    columns.clear();
+
+    for (std::uint32_t const slot : this->slots[index])
+        columns.push_back({&values[slot], 0});
+
+    evaluate(this->programs[index], columns, 1, {&result, 1}, scratch);
+
+    return result;
+}
+
+mlp::Minimum mlp::Minimiser::minimise(
+    std::span<Constant const> const start,
+    std::span<Constant const> const parameters,
+    MinimiseOptions const &options
+) const {
+    std::size_t const n = this->count;
+
+    if (start.size() != n)
+        throw std::runtime_error{"Mismatched variable count!"};
+
+    if (parameters.size() < this->names.size())
+        throw std::runtime_error{"Missing value for variable!"};
+
+    // The point followed by the parameters, as the slots index them.
+    std::vector<Constant> values(start.begin(), start.end());
+    values.insert(
+        values.end(), parameters.begin(),
+        parameters.begin() + this->names.size()
+    );
+
+    std::vector<Column> columns;
+    std::vector<Constant> scratch;
+    std::vector<Constant> gradient(n);
+    std::vector<Constant> next(n);
+    std::vector<Constant> direction(n);
+    std::vector<Constant> origin(n);
+
+    auto const evaluate_gradient = [&](std::vector<Constant> &result) {
+        for (std::size_t i = 0; i < n; ++i)
+            result[i] = this->run(1 + i, values, columns, scratch);
+    };
+
+    struct Correction final {
+        std::vector<Constant> s;
+        std::vector<Constant> y;
+        Constant rho;
+    };
+
+    std::deque<Correction> history;
+
+    Constant value = this->run(0, values, columns, scratch);
+    evaluate_gradient(gradient);
+
+    auto const converged = [&gradient, &options] {
+        return std::ranges::all_of(gradient, [&options](Constant const g) {
+            return std::fabs(g) <= options.tolerance;
+        });
+    };
+
+    auto const result = [&](std::uint32_t const iterations,
+                            MinimumStatus const status) {
+        return Minimum{
+            {values.begin(), values.begin() + n}, value, iterations, status
+        };
+    };
+
+    for (std::uint32_t iteration = 0; iteration < options.iterations;
+         ++iteration) {
+        if (converged())
+            return result(iteration, MinimumStatus::converged);
+
+        std::ranges::transform(gradient, direction.begin(), std::negate{});
+
+        if (this->descent == Descent::newton) {
+            std::vector<Constant> matrix(n * n);
+
+            for (std::size_t i = 0, k = 1 + n; i < n; ++i)
+                for (std::size_t j = i; j < n; ++j, ++k)
+                    matrix[i * n + j] = matrix[j * n + i] =
+                        this->run(k, values, columns, scratch);
+
+            // Levenberg damping: shift the diagonal until the factorisation
+            // succeeds, so the step always descends.
+            Constant damping = 0;
+
+            for (std::uint32_t attempt = 0; attempt < k_attempts; ++attempt) {
+                std::vector<Constant> factor = matrix;
+
+                for (std::size_t i = 0; i < n; ++i)
+                    factor[i * n + i] += damping;
+
+                if (cholesky(factor, n)) {
+                    substitute(factor, n, direction);
+
+                    break;
+                }
+
+                damping = std::max(2 * damping, 1e-8);
+            }
+        } else if (!history.empty()) {
+            std::vector<Constant> alpha(history.size());
+
+            for (std::size_t i = history.size(); i-- > 0;) {
+                alpha[i] = history[i].rho * dot(history[i].s, direction);
+
+                for (std::size_t j = 0; j < n; ++j)
+                    direction[j] -= alpha[i] * history[i].y[j];
+            }
+
+            Correction const &last = history.back();
+            Constant const gamma = dot(last.s, last.y) / dot(last.y, last.y);
+
+            for (Constant &component : direction)
+                component *= gamma;
+
+            for (std::size_t i = 0; i < history.size(); ++i) {
+                Constant const beta =
+                    history[i].rho * dot(history[i].y, direction);
+
+                for (std::size_t j = 0; j < n; ++j)
+                    direction[j] += (alpha[i] - beta) * history[i].s[j];
+            }
+        }
+
+        Constant slope = dot(gradient, direction);
+
+        if (!(slope < 0)) {
+            std::ranges::transform(gradient, direction.begin(), std::negate{});
+            slope = dot(gradient, direction);
+        }
+
+        std::copy_n(values.begin(), n, origin.begin());
+
+        // Weak Wolfe search by bisection: the step shrinks while it does not
+        // decrease the objective enough and grows while the slope is still
+        // steep, which keeps the L-BFGS curvature pairs usable.
+        Constant low = 0;
+        Constant high = std::numeric_limits<Constant>::infinity();
+        Constant step = 1;
+        Constant trial = value;
+        bool accepted = false;
+
+        auto const probe = [&](Constant const length) {
+            for (std::size_t i = 0; i < n; ++i)
+                values[i] = origin[i] + length * direction[i];
+
+            return this->run(0, values, columns, scratch);
+        };
+
+        for (std::uint32_t attempt = 0; attempt < k_attempts; ++attempt) {
+            trial = probe(step);
+
+            if (!(std::isfinite(trial) &&
+                  trial <= value + k_armijo * step * slope)) {
+                high = step;
+            } else {
+                evaluate_gradient(next);
+
+                if (dot(next, direction) >= k_wolfe * slope) {
+                    accepted = true;
+
+                    break;
+                }
+
+                low = step;
+            }
+
+            step = std::isinf(high) ? 2 * low : (low + high) / 2;
+        }
+
+        if (!accepted && low == 0) {
+            std::copy_n(origin.begin(), n, values.begin());
+
+            return result(iteration, MinimumStatus::stalled);
+        }
+
+        if (!accepted) {
+            trial = probe(low);
+            evaluate_gradient(next);
+        }
+
+        if (this->descent == Descent::lbfgs) {
+            Correction correction{
+                std::vector<Constant>(n), std::vector<Constant>(n), 0
+            };
+
+            for (std::size_t i = 0; i < n; ++i) {
+                correction.s[i] = values[i] - origin[i];
+                correction.y[i] = next[i] - gradient[i];
+            }
+
+            // Pairs without positive curvature would break the implicit
+            // Hessian's positive definiteness.
+            if (Constant const curvature = dot(correction.s, correction.y);
+                curvature > 1e-12 * std::sqrt(
+                                        dot(correction.y, correction.y) *
+                                        dot(correction.s, correction.s)
+                                    )) {
+                correction.rho = 1 / curvature;
+                history.push_back(std::move(correction));
+
+                if (history.size() > std::max(options.memory, 1u))
+                    history.pop_front();
+            }
+        }
+
+        value = trial;
+        std::swap(gradient, next);
+    }
+
+    return result(
+        options.iterations,
+        converged() ? MinimumStatus::converged : MinimumStatus::exhausted
+    );
+}
@@ -0,0 +1,539 @@
+#include "../include/ode.h"
+
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+namespace {
+// Dormand-Prince 5(4): the nodes, the lower triangle of the tableau, whose
+// last row is also the fifth order solution, and the difference between the
+// fifth and fourth order weights.
+constexpr std::array<mlp::Constant, 7> k_nodes{
+    0, 1.0 / 5, 3.0 / 10, 4.0 / 5, 8.0 / 9, 1, 1
+};
+
+constexpr std::array<std::array<mlp::Constant, 6>, 7> k_tableau{{
+    {},
+    {1.0 / 5},
+    {3.0 / 40, 9.0 / 40},
+    {44.0 / 45, -56.0 / 15, 32.0 / 9},
+    {19372.0 / 6561, -25360.0 / 2187, 64448.0 / 6561, -212.0 / 729},
+    {9017.0 / 3168, -355.0 / 33, 46732.0 / 5247, 49.0 / 176,
+     -5103.0 / 18656},
+    {35.0 / 384, 0, 500.0 / 1113, 125.0 / 192, -2187.0 / 6784, 11.0 / 84},
+}};
+
+constexpr std::array<mlp::Constant, 7> k_error{
+    71.0 / 57600,  0,           -71.0 / 16695, 71.0 / 1920,
+    -17253.0 / 339200, 22.0 / 525, -1.0 / 40
+};
+
+// ROS2 with gamma = 1 + 1 / sqrt(2), which makes it L-stable.
+constexpr mlp::Constant k_gamma = 1.7071067811865475;
+
+// Factors the matrix in place into L U with partial pivoting, or returns
+// false if it is singular.
+bool factor(
+    std::span<mlp::Constant> const matrix, std::span<std::size_t> const pivots,
+    std::size_t const size
+) {
+    for (std::size_t j = 0; j < size; ++j) {
+        std::size_t pivot = j;
+
+        for (std::size_t i = j + 1; i < size; ++i)
+            if (std::fabs(matrix[i * size + j]) >
+                std::fabs(matrix[pivot * size + j]))
+                pivot = i;
+
+        if (!(matrix[pivot * size + j] != 0))
+            return false;
+
+        pivots[j] = pivot;
+
+        if (pivot != j)
+            std::swap_ranges(
+                matrix.begin() + j * size, matrix.begin() + (j + 1) * size,
+                matrix.begin() + pivot * size
+            );
+
+        for (std::size_t i = j + 1; i < size; ++i) {
+            mlp::Constant const multiplier =
+                matrix[i * size + j] /= matrix[j * size + j];
+
+            for (std::size_t k = j + 1; k < size; ++k)
+                matrix[i * size + k] -= multiplier * matrix[j * size + k];
+        }
+    }
+
+    return true;
+}
+
+// Solves L U x = b in place for the factor left by factor().
+void substitute(
+    std::span<mlp::Constant const> const matrix,
+    std::span<std::size_t const> const pivots, std::size_t const size,
+    std::span<mlp::Constant> const x
+) {
+    for (std::size_t i = 0; i < size; ++i) {
+        std::swap(x[i], x[pivots[i]]);
+
+        for (std::size_t k = 0; k < i; ++k)
+            x[i] -= matrix[i * size + k] * x[k];
+    }
+
+    for (std::size_t i = size; i-- > 0;) {
+        for (std::size_t k = i + 1; k < size; ++k)
+            x[i] -= matrix[i * size + k] * x[k];
+
+        x[i] /= matrix[i * size + i];
+    }
+}
+
+// Evaluates a program for the given rows of a block, gathering its inputs
+// from per-row times and states and from the parameter columns. Results are
+// stored row by row, all outputs of a row together.
+class Kernel final {
+    mlp::ProgramView program;
+    std::span<std::uint32_t const> slots;
+    std::size_t count;
+    std::span<mlp::Constant const> parameters;
+    std::size_t rows;
+    std::size_t begin;
+    std::vector<mlp::Column> columns;
+    std::vector<mlp::Constant> scratch;
+
+  public:
+    Kernel(
+        mlp::ProgramView const program,
+        std::span<std::uint32_t const> const slots, std::size_t const count,
+        std::span<mlp::Constant const> const parameters,
+        std::size_t const rows, std::size_t const begin
+    )
+        : program(program), slots(slots), count(count),
+          parameters(parameters), rows(rows), begin(begin) {}
+
+    void operator()(
+        std::span<std::size_t const> const active,
+        std::span<mlp::Constant const> const times,
+        std::span<mlp::Constant const> const states,
+        std::span<mlp::Constant> const results
+    ) {
+        this->columns.clear();
+
+        for (std::size_t const slot : this->slots)
+            if (slot == 0)
+                this->columns.push_back({times.data()});
+            else if (slot <= this->count)
+                this->columns.push_back(
+                    {states.data() + slot - 1, this->count}
+                );
+            else
+                this->columns.push_back(
+                    {this->parameters.data() +
+                         (slot - 1 - this->count) * this->rows + this->begin,
+                     1, active}
+                );
+
+        mlp::evaluate(
+            this->program, this->columns, active.size(),
+            results.first(active.size() * this->program.outputs),
+            this->scratch
+        );
+    }
+};
+} // namespace
+
+mlp::OdeSolver::OdeSolver(
+    std::vector<Token> const &rhs, std::vector<Variable> const &states,
+    Variable const time, OdeScheme const scheme
+)
+    : scheme(scheme), count(states.size()) {
+    if (rhs.size() != states.size())
+        throw std::runtime_error{"Mismatched equation count!"};
+
+    this->programs.emplace_back(std::span<Token const>{rhs});
+
+    if (scheme == OdeScheme::rosenbrock) {
+        std::vector<Token> jacobian;
+        jacobian.reserve(this->count * (this->count + 1));
+
+        for (Token const &component : rhs)
+            for (Variable const &state : states)
+                jacobian.push_back(
+                    simplified(derivative(component, state, 1))
+                );
+
+        for (Token const &component : rhs)
+            jacobian.push_back(simplified(derivative(component, time, 1)));
+
+        this->programs.emplace_back(std::span<Token const>{jacobian});
+    }
+
+    auto const position = [&states](char const input) -> std::size_t {
+        return std::ranges::find(states, Variable{input}) - states.begin();
+    };
+
+    for (Program const &program : this->programs)
+        for (char const input : program.variables())
+            if (!(Variable{input} == time) &&
+                position(input) == states.size() &&
+                this->names.find(input) == std::string::npos)
+                this->names += input;
+
+    for (Program const &program : this->programs) {
+        auto &slots = this->slots.emplace_back();
+
+        for (char const input : program.variables()) {
+            std::size_t const index = position(input);
+
+            slots.push_back(
+                Variable{input} == time ? 0
+                : index < this->count
+                    ? 1 + index
+                    : 1 + this->count + this->names.find(input)
+            );
+        }
+    }
+}
+
+std::string_view mlp::OdeSolver::parameters() const { return this->names; }
+
+void mlp::OdeSolver::integrate(
+    Constant const start, Constant const end, std::span<Constant> const states,
+    std::span<Constant const> const parameters,
+    std::span<OdeStatus> const status, OdeOptions const &options
+) const {
+    std::size_t const rows = status.size();
+    std::size_t const n = this->count;
+
+    if (states.size() != n * rows)
+        throw std::runtime_error{"Mismatched row counts!"};
+
+    if (parameters.size() < this->names.size() * rows)
+        throw std::runtime_error{"Missing value for variable!"};
+
+    Constant const direction = end < start ? -1 : 1;
+    bool const implicit = this->scheme == OdeScheme::rosenbrock;
+    Constant const exponent = implicit ? 1.0 / 2 : 1.0 / 5;
+
+    parallel_blocks(
+        rows,
+        [&](std::size_t const begin, std::size_t const width) {
+
+            Kernel rhs{
+                this->programs.front(), this->slots.front(), n, parameters,
+                rows, begin
+            };
+
+            // Per row, indexed by row.
+            std::vector<Constant> t(width, start);
+            std::vector<Constant> h(width);
+            std::vector<Constant> y(width * n);
+            std::vector<Constant> slope(width * n);
+            std::vector<std::uint32_t> steps(width);
+
+            // Per attempt, indexed by position in active.
+            std::vector<Constant> times(width);
+            std::vector<Constant> base(width * n);
+            std::vector<Constant> stage(width * n);
+            std::vector<Constant> next(width * n);
+            std::vector<Constant> error(width);
+            std::array<std::vector<Constant>, 7> k;
+
+            for (std::size_t row = 0; row < width; ++row)
+                for (std::size_t j = 0; j < n; ++j)
+                    y[row * n + j] = states[j * rows + begin + row];
+
+            auto const finish = [&](
+                                    std::size_t const row,
+                                    OdeStatus const result
+                                ) {
+                for (std::size_t j = 0; j < n; ++j)
+                    states[j * rows + begin + row] = y[row * n + j];
+
+                status[begin + row] = result;
+            };
+
+            std::vector<std::size_t> active(width);
+
+            for (std::size_t row = 0; row < width; ++row)
+                active[row] = row;
+
+            if (start == end) {
+                for (std::size_t const row : active)
+                    finish(row, OdeStatus::finished);
+
+                return;
+            }
+
+            rhs(active, t, y, slope);
+
+            for (std::size_t row = 0; row < width; ++row) {
+                Constant size = std::fabs(options.step);
+
+                if (size == 0) {
+                    // The step that moves y by a hundredth of its scale.
+                    Constant state = 0;
+                    Constant change = 0;
+
+                    for (std::size_t j = 0; j < n; ++j) {
+                        Constant const scale =
+                            options.absolute +
+                            options.tolerance * std::fabs(y[row * n + j]);
+
+                        state =
+                            std::max(state, std::fabs(y[row * n + j]) / scale);
+                        change = std::max(
+                            change, std::fabs(slope[row * n + j]) / scale
+                        );
+                    }
+
+                    size = state < 1e-5 || change < 1e-5
+                               ? 1e-6
+                               : 0.01 * state / change;
+                }
+
+                h[row] = direction * std::min(size, std::fabs(end - start));
+            }
+
+            std::optional<Kernel> jacobian;
+            std::vector<Constant> matrices;
+            std::vector<std::size_t> pivots;
+
+            if (implicit)
+                jacobian.emplace(
+                    this->programs.back(), this->slots.back(), n, parameters,
+                    rows, begin
+                );
+
+            for (auto &stages : k)
+                stages.resize(width * n);
+
+            while (!active.empty()) {
+                std::size_t const size = active.size();
+
+                for (std::size_t i = 0; i < size; ++i) {
+                    times[i] = t[active[i]];
+                    std::copy_n(
+                        y.begin() + active[i] * n, n, base.begin() + i * n
+                    );
+                }
+
+                // Leaves the new states in next and their error estimates
+                // in stage, or an infinite error where the step failed.
+                std::ranges::fill(error, 0);
+
+                if (!implicit) {
+                    for (std::size_t i = 0; i < size; ++i)
+                        std::copy_n(
+                            slope.begin() + active[i] * n, n,
+                            k[0].begin() + i * n
+                        );
+
+                    for (std::size_t s = 1; s < 7; ++s) {
+                        std::vector<Constant> &target = s < 6 ? stage : next;
+
+                        for (std::size_t i = 0; i < size; ++i) {
+                            Constant const step = h[active[i]];
+
+                            for (std::size_t j = 0; j < n; ++j) {
+                                Constant sum = 0;
+
+                                for (std::size_t l = 0; l < s; ++l)
+                                    sum += k_tableau[s][l] * k[l][i * n + j];
+
+                                target[i * n + j] =
+                                    base[i * n + j] + step * sum;
+                            }
+
+                            times[i] = t[active[i]] + k_nodes[s] * step;
+                        }
+
+                        rhs(active, times, target, k[s]);
+                    }
+
+                    for (std::size_t i = 0; i < size; ++i)
+                        for (std::size_t j = 0; j < n; ++j) {
+                            Constant sum = 0;
+
+                            for (std::size_t l = 0; l < 7; ++l)
+                                sum += k_error[l] * k[l][i * n + j];
+
+                            stage[i * n + j] = h[active[i]] * sum;
+                        }
+                } else {
+                    std::size_t const entries = n * n + n;
+                    matrices.resize(size * entries);
+                    pivots.resize(size * n);
+
+                    rhs(active, times, base, k[0]);
+                    (*jacobian)(active, times, base, matrices);
+
+                    // W = I - gamma h J, then
+                    // W k1 = f(t, y) + gamma h f_t,
+                    // W k2 = f(t + h, y + h k1) - 2 k1 - gamma h f_t.
+                    for (std::size_t i = 0; i < size; ++i) {
+                        Constant const step = h[active[i]];
+                        std::span const matrix =
+                            std::span{matrices}.subspan(i * entries, n * n);
+                        std::span const drift =
+                            std::span{matrices}.subspan(i * entries + n * n, n);
+                        std::span const k1 = std::span{k[0]}.subspan(i * n, n);
+
+                        for (std::size_t j = 0; j < n * n; ++j)
+                            matrix[j] *= -k_gamma * step;
+
+                        for (std::size_t j = 0; j < n; ++j)
+                            matrix[j * n + j] += 1;
+
+                        for (std::size_t j = 0; j < n; ++j)
+                            drift[j] *= k_gamma * step;
+
+                        if (!factor(
+                                matrix, std::span{pivots}.subspan(i * n, n), n
+                            )) {
+                            error[i] =
+                                std::numeric_limits<Constant>::infinity();
+                            std::copy_n(
+                                base.begin() + i * n, n, stage.begin() + i * n
+                            );
+                            times[i] = t[active[i]];
+
+                            continue;
+                        }
+
+                        for (std::size_t j = 0; j < n; ++j)
+                            k1[j] += drift[j];
+
+                        substitute(
+                            matrix, std::span{pivots}.subspan(i * n, n), n, k1
+                        );
+
+                        for (std::size_t j = 0; j < n; ++j)
+                            stage[i * n + j] = base[i * n + j] + step * k1[j];
+
+                        times[i] = t[active[i]] + step;
+                    }
+
+                    rhs(active, times, stage, k[1]);
+
+                    for (std::size_t i = 0; i < size; ++i) {
+                        if (std::isinf(error[i]))
+                            continue;
+
+                        Constant const step = h[active[i]];
+                        std::span const k1 = std::span{k[0]}.subspan(i * n, n);
+                        std::span const k2 = std::span{k[1]}.subspan(i * n, n);
+
+                        std::span const drift = std::span{matrices}.subspan(
+                            i * entries + n * n, n
+                        );
+
+                        for (std::size_t j = 0; j < n; ++j)
+                            k2[j] -= 2 * k1[j] + drift[j];
+
+                        substitute(
+                            std::span{matrices}.subspan(i * entries, n * n),
+                            std::span{pivots}.subspan(i * n, n), n, k2
+                        );
+
+                        for (std::size_t j = 0; j < n; ++j) {
+                            next[i * n + j] =
+                                base[i * n + j] +
+                                step * (1.5 * k1[j] + 0.5 * k2[j]);
+                            stage[i * n + j] = step / 2 * (k1[j] + k2[j]);
+                        }
+                    }
+                }
+
+                for (std::size_t i = 0; i < size; ++i) {
+                    if (std::isinf(error[i]))
+                        continue;
+
+                    for (std::size_t j = 0; j < n; ++j)
+                        error[i] = std::max(
+                            error[i], std::fabs(stage[i * n + j]) /
+                                          (options.absolute +
+                                           options.tolerance *
+                                               std::max(
+                                                   std::fabs(base[i * n + j]),
+                                                   std::fabs(next[i * n + j])
+                                               ))
+                        );
+
+                    // A NaN anywhere rejects the step.
+                    if (std::isnan(error[i]))
+                        error[i] = std::numeric_limits<Constant>::infinity();
+                }
+                std::size_t remaining = 0;
+
+                for (std::size_t i = 0; i < size; ++i) {
+                    std::size_t const row = active[i];
+                    bool const accepted = error[i] <= 1;
+
+                    if (accepted) {
+                        t[row] = std::fabs(end - t[row]) <= std::fabs(h[row])
+                                     ? end
+                                     : t[row] + h[row];
+
+                        std::copy_n(
+                            next.begin() + i * n, n, y.begin() + row * n
+                        );
+
+                        if (!implicit)
+                            std::copy_n(
+                                k[6].begin() + i * n, n,
+                                slope.begin() + row * n
+                            );
+
+                        if (t[row] == end) {
+                            finish(row, OdeStatus::finished);
+
+                            continue;
+                        }
+                    }
+
+                    if (++steps[row] >= options.steps) {
+                        finish(row, OdeStatus::exhausted);
+
+                        continue;
+                    }
+
+                    Constant factor =
+                        std::isfinite(error[i])
+                            ? std::clamp(
+                                  0.9 * std::pow(error[i], -exponent), 0.2, 5.0
+                              )
+                            : 0.2;
+
+                    if (!accepted)
+                        factor = std::min(factor, 1.0);
+
+                    h[row] = direction * std::min(
+                                             std::fabs(h[row] * factor),
+                                             std::fabs(end - t[row])
+                                         );
+
+                    if (std::fabs(h[row]) <=
+                        16 * std::numeric_limits<Constant>::epsilon() *
+                            std::max(std::fabs(t[row]), 1.0)) {
+                        finish(row, OdeStatus::stalled);
+
+                        continue;
+                    }
+
+                    active[remaining++] = row;
+                }
+
+                active.resize(remaining);
+            }
+        }
+    );
+}
@@ -0,0 +1,235 @@
+#include "../include/pool.h"
+
+#include "../include/cancellation.h"
+#include "../include/context.h"
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+#include "../include/variable.h"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+namespace {
+thread_local mlp::Pool const *t_pool = nullptr;
+thread_local std::size_t t_index = 0;
+
+// The chunks of one Pool::run. The caller and the helper tasks it queues
+// claim chunks from the same counter, so no thread runs work from another
+// call while this one waits. Helpers hold it by shared_ptr because a helper
+// may only start after the caller has claimed everything and returned.
+struct Run final {
+    std::function<void(std::size_t)> const &body;
+    std::size_t count;
+    std::size_t chunks;
+
+    std::atomic<std::size_t> claimed{0};
+    std::atomic<std::size_t> remaining;
+    std::atomic<std::size_t> failed{std::numeric_limits<std::size_t>::max()};
+    std::mutex mutex;
+    std::exception_ptr error;
+
+    Run(
+        std::function<void(std::size_t)> const &body, std::size_t const count,
+        std::size_t const chunks
+    )
+        : body(body), count(count), chunks(chunks), remaining(chunks) {}
+
+    // Runs chunks until none are left to claim.
+    void help() {
+        for (std::size_t chunk;
+             (chunk = this->claimed.fetch_add(1, std::memory_order_relaxed)) <
+             this->chunks;) {
+            std::size_t const begin = this->count * chunk / this->chunks;
+            std::size_t const end = this->count * (chunk + 1) / this->chunks;
+
+            for (std::size_t i = begin; i < end; ++i) {
+                if (i > this->failed.load(std::memory_order_relaxed))
+                    break;
+
+                try {
+                    this->body(i);
+                } catch (...) {
+                    std::lock_guard const lock{this->mutex};
+
+                    if (i < this->failed.load(std::memory_order_relaxed)) {
+                        this->failed.store(i, std::memory_order_relaxed);
+                        this->error = std::current_exception();
+                    }
+
+                    break;
+                }
+            }
+
+            if (this->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                this->remaining.notify_all();
+        }
+    }
+};
+} // namespace
+
+mlp::Pool::Pool(std::size_t const workers) {
+    for (std::size_t i = 0; i < std::max<std::size_t>(workers, 1); ++i)
+        this->queues.push_back(std::make_unique<Queue>());
+
+    for (std::size_t i = 0; i < workers; ++i)
+        this->workers.emplace_back([this, i] { this->work(i); });
+}
+
+mlp::Pool::~Pool() {
+    {
+        std::lock_guard const lock{this->sleep};
+        this->stopping = true;
+    }
+
+    this->wake.notify_all();
+    this->workers.clear();
+}
+
+mlp::Pool &mlp::Pool::shared() {
+    static Pool pool{std::max(std::thread::hardware_concurrency(), 2u) - 1};
+
+    return pool;
+}
+
+std::size_t mlp::Pool::size() const { return this->workers.size() + 1; }
+
+void mlp::Pool::push(Task task) {
+    std::size_t const index =
+        t_pool == this ? t_index
+                       : this->next.fetch_add(1, std::memory_order_relaxed) %
+                             this->queues.size();
+
+    {
+        std::lock_guard const lock{this->queues[index]->mutex};
+        this->queues[index]->tasks.push_back(std::move(task));
+        this->pending.fetch_add(1, std::memory_order_release);
+    }
+
+    {
+        std::lock_guard const lock{this->sleep};
+    }
+
+    this->wake.notify_one();
+}
+
+bool mlp::Pool::pop(Task &task) {
+    std::size_t const count = this->queues.size();
+    std::size_t const start = t_pool == this ? t_index : 0;
+
+    if (t_pool == this) {
+        Queue &own = *this->queues[start];
+        std::lock_guard const lock{own.mutex};
+
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            this->pending.fetch_sub(1, std::memory_order_relaxed);
+
+            return true;
+        }
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        Queue &victim = *this->queues[(start + i) % count];
+        std::lock_guard const lock{victim.mutex};
+
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            this->pending.fetch_sub(1, std::memory_order_relaxed);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void mlp::Pool::work(std::size_t const index) {
+    t_pool = this;
+    t_index = index;
+
+    while (true) {
+        if (Task task; this->pop(task)) {
+            task();
+
+            continue;
+        }
+
+        std::unique_lock lock{this->sleep};
+
+        this->wake.wait(lock, [this] {
+            return this->stopping ||
+                   this->pending.load(std::memory_order_acquire) > 0;
+        });
+
+        if (this->stopping && !this->pending.load(std::memory_order_acquire))
+            return;
+    }
+}
+
+void mlp::Pool::submit(Task task) { this->push(std::move(task)); }
+
+void mlp::Pool::run(
+    std::size_t const count, std::function<void(std::size_t)> const &body
+) {
+    if (!count)
+        return;
+
+    std::size_t const chunks = std::min(count, this->size() * 4);
+    auto const run = std::make_shared<Run>(body, count, chunks);
+
+    for (std::size_t i = 0; i < std::min(chunks - 1, this->workers.size());
+         ++i)
+        this->push([run] { run->help(); });
+
+    run->help();
+
+    for (std::size_t remaining;
+         (remaining = run->remaining.load(std::memory_order_acquire));)
+        run->remaining.wait(remaining, std::memory_order_acquire);
+
+    if (run->error)
+        std::rethrow_exception(run->error);
+}
+
+std::size_t mlp::parallel_block(std::size_t const count) {
+    std::size_t const threshold = Context::current().parallel_threshold();
+
+    if (!threshold || count < threshold ||
+        std::thread::hardware_concurrency() < 2)
+        return 0;
+
+    return threshold;
+}
+
+void mlp::parallel_for(
+    std::size_t const count, std::function<void(std::size_t)> const &body,
+    std::size_t const items
+) {
+    if (count < 2 || !parallel_block(count * items)) {
+        for (std::size_t i = 0; i < count; ++i)
+            body(i);
+
+        return;
+    }
+
+    Context &context = Context::current();
+    auto const registry = context.snapshot();
+    auto const state = cancellation::current();
+
+    Pool::shared().run(
+        count,
+        [&context, &registry, &state, &body](std::size_t const i) {
+            Context::Scope const scope{context, registry};
+            cancellation::Scope const cancellation{state};
+
+            body(i);
+        }
+    );
+}
@@ -0,0 +1,829 @@
+#include "../include/program.h"
+
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/pool.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+#include "../include/variable.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <map>
+#include <ranges>
+#include <set>
+#include <tuple>
+
+namespace {
+// Rows per block of parallel_blocks, enough to spread the interpreter's
+// dispatch over many rows while a block's stack stays in cache.
+constexpr std::size_t k_block = 256;
+
+struct Compiler final {
+    std::vector<mlp::Instruction> instructions{};
+    std::string const &inputs;
+    std::uint32_t size{0};
+    std::uint32_t depth{0};
+
+    void emit(
+        mlp::OpCode const code, std::uint32_t const operand = 0,
+        mlp::Constant const value = 0
+    ) {
+        this->instructions.push_back({code, operand, value});
+
+        if (code == mlp::OpCode::constant || code == mlp::OpCode::load)
+            this->depth = std::max(this->depth, ++this->size);
+
+        else if (code == mlp::OpCode::add || code == mlp::OpCode::mul)
+            this->size -= operand - 1;
+
+        else if (code == mlp::OpCode::pow)
+            --this->size;
+    }
+};
+
+std::uint32_t arity(mlp::Instruction const &instruction) {
+    switch (instruction.code) {
+    case mlp::OpCode::constant:
+    case mlp::OpCode::load:
+    case mlp::OpCode::fetch:
+        return 0;
+
+    case mlp::OpCode::add:
+    case mlp::OpCode::mul:
+        return instruction.operand;
+
+    case mlp::OpCode::pow:
+        return 2;
+
+    default:
+        return 1;
+    }
+}
+
+std::uint32_t measure(std::span<mlp::Instruction const> const instructions) {
+    std::uint32_t size = 0;
+    std::uint32_t depth = 0;
+
+    for (mlp::Instruction const &instruction : instructions) {
+        if (instruction.code == mlp::OpCode::store)
+            continue;
+
+        size -= arity(instruction);
+
+        if (instruction.code != mlp::OpCode::output)
+            depth = std::max(depth, ++size);
+    }
+
+    return depth;
+}
+
+// Value numbering over postfix code: every instruction becomes a node over
+// the nodes of its operands, and structurally equal nodes get the same
+// number. The code is then emitted again with every non-leaf number that is
+// used more than once stored on first use and fetched afterwards.
+class Sharer final {
+    using Key = std::tuple<
+        mlp::OpCode, std::uint32_t, std::uint64_t, std::vector<std::uint32_t>>;
+
+    struct Node final {
+        mlp::Instruction instruction;
+        std::vector<std::uint32_t> children;
+        std::uint32_t number;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<std::uint32_t> roots;
+    std::map<Key, std::uint32_t> numbers;
+    std::vector<std::uint32_t> uses;
+    // Register plus one for every number, or 0 before it is stored.
+    std::vector<std::uint32_t> slots;
+
+    void count(std::uint32_t const index) {
+        Node const &node = this->nodes[index];
+
+        if (++this->uses[node.number] == 1)
+            for (std::uint32_t const child : node.children)
+                this->count(child);
+    }
+
+    void emit(std::uint32_t const index) {
+        Node const &node = this->nodes[index];
+
+        if (std::uint32_t const slot = this->slots[node.number]) {
+            this->code.push_back({mlp::OpCode::fetch, slot - 1, 0});
+
+            return;
+        }
+
+        for (std::uint32_t const child : node.children)
+            this->emit(child);
+
+        this->code.push_back(node.instruction);
+
+        if (this->uses[node.number] > 1 && !node.children.empty()) {
+            this->slots[node.number] = ++this->registers;
+            this->code.push_back({mlp::OpCode::store, this->registers - 1, 0});
+        }
+    }
+
+  public:
+    std::vector<mlp::Instruction> code;
+    std::uint32_t registers{0};
+
+    explicit Sharer(std::span<mlp::Instruction const> const instructions) {
+        std::vector<std::uint32_t> stack;
+
+        for (mlp::Instruction const &instruction : instructions) {
+            std::size_t const operands = arity(instruction);
+            std::vector<std::uint32_t> children(stack.end() - operands,
+                                                stack.end());
+            stack.resize(stack.size() - operands);
+
+            auto const index = static_cast<std::uint32_t>(this->nodes.size());
+
+            if (instruction.code == mlp::OpCode::output) {
+                this->nodes.push_back({instruction, std::move(children), 0});
+                this->roots.push_back(index);
+
+                continue;
+            }
+
+            Key key{
+                instruction.code, instruction.operand,
+                std::bit_cast<std::uint64_t>(instruction.value), {}
+            };
+
+            for (std::uint32_t const child : children)
+                std::get<3>(key).push_back(this->nodes[child].number);
+
+            auto const number = this->numbers
+                                    .try_emplace(
+                                        std::move(key),
+                                        static_cast<std::uint32_t>(
+                                            this->numbers.size()
+                                        )
+                                    )
+                                    .first->second;
+
+            this->nodes.push_back({instruction, std::move(children), number});
+            stack.push_back(index);
+        }
+
+        this->uses.resize(this->numbers.size());
+        this->slots.resize(this->numbers.size());
+
+        for (std::uint32_t const root : this->roots)
+            this->count(this->nodes[root].children[0]);
+
+        for (std::uint32_t const root : this->roots) {
+            this->emit(this->nodes[root].children[0]);
+            this->code.push_back(this->nodes[root].instruction);
+        }
+    }
+};
+} // namespace
+
+namespace mlp {
+class Program::Builder final {
+  public:
+    static void compile(Compiler &compiler, Token const &token);
+
+    static void collect(Token const &token, std::set<Variable> &variables);
+};
+
+void Program::Builder::collect(
+    Token const &token, std::set<Variable> &variables
+) {
+    std::visit(
+        [&variables]<typename T>(T const &var) {
+            if constexpr (std::is_same_v<T, Variable>) {
+                variables.insert(var);
+            } else if constexpr (std::is_same_v<T, Function>) {
+                if (auto const body = inlined(var)) {
+                    collect(*body, variables);
+
+                    return;
+                }
+
+                for (Token const &parameter : var.parameters)
+                    collect(parameter, variables);
+            } else if constexpr (std::is_same_v<T, Term>) {
+                collect(*var.base, variables);
+                collect(*var.power, variables);
+            } else if constexpr (std::is_same_v<T, Terms>) {
+                for (Token const &term : var.terms)
+                    collect(term, variables);
+            } else if constexpr (std::is_same_v<T, Expression>) {
+                for (Token const &term : var.tokens | std::views::values)
+                    collect(term, variables);
+            }
+        },
+        token
+    );
+}
+
+void Program::Builder::compile(Compiler &compiler, Token const &token) {
+    std::visit(
+        [&compiler]<typename T>(T const &var) {
+            if constexpr (std::is_same_v<T, Constant>) {
+                compiler.emit(OpCode::constant, 0, var);
+            } else if constexpr (std::is_same_v<T, Variable>) {
+                compiler.emit(
+                    OpCode::load,
+                    static_cast<std::uint32_t>(compiler.inputs.find(var.var)),
+                    var.coefficient
+                );
+            } else if constexpr (std::is_same_v<T, Function>) {
+                if (auto const body = inlined(var)) {
+                    compile(compiler, *body);
+
+                    return;
+                }
+
+                auto const id = builtin_id(var.function);
+
+                if (!id || var.parameters.size() != 1)
+                    throw std::runtime_error{"Cannot compile custom function!"};
+
+                compile(compiler, var.parameters[0]);
+                compiler.emit(OpCode::call, *id);
+            } else if constexpr (std::is_same_v<T, Term>) {
+                compile(compiler, *var.base);
+
+                if (std::holds_alternative<Constant>(*var.power)) {
+                    compiler.emit(
+                        OpCode::power, 0, std::get<Constant>(*var.power)
+                    );
+                } else {
+                    compile(compiler, *var.power);
+                    compiler.emit(OpCode::pow);
+                }
+
+                if (var.coefficient != 1)
+                    compiler.emit(OpCode::scale, 0, var.coefficient);
+            } else if constexpr (std::is_same_v<T, Terms>) {
+                if (var.terms.empty()) {
+                    compiler.emit(OpCode::constant, 0, var.coefficient);
+
+                    return;
+                }
+
+                for (Token const &term : var.terms)
+                    compile(compiler, term);
+
+                if (var.terms.size() > 1)
+                    compiler.emit(
+                        OpCode::mul,
+                        static_cast<std::uint32_t>(var.terms.size())
+                    );
+
+                if (var.coefficient != 1)
+                    compiler.emit(OpCode::scale, 0, var.coefficient);
+            } else {
+                if (var.tokens.empty()) {
+                    compiler.emit(OpCode::constant, 0, 0);
+
+                    return;
+                }
+
+                for (auto const &[sign, term] : var.tokens) {
+                    compile(compiler, term);
+
+                    if (sign == Sign::neg)
+                        compiler.emit(OpCode::neg);
+                }
+
+                if (var.tokens.size() > 1)
+                    compiler.emit(
+                        OpCode::add,
+                        static_cast<std::uint32_t>(var.tokens.size())
+                    );
+            }
+        },
+        token
+    );
+}
+} // namespace mlp
+
+mlp::Program::Program(Token const &token) {
+    std::set<Variable> variables;
+    Builder::collect(token, variables);
+
+    for (Variable const &variable : variables)
+        this->inputs.push_back(variable.var);
+
+    Compiler compiler{.inputs = this->inputs};
+    Builder::compile(compiler, token);
+
+    this->instructions = std::move(compiler.instructions);
+    this->depth = compiler.depth;
+}
+
+mlp::Program::Program(std::span<Token const> const tokens) {
+    if (tokens.empty())
+        throw std::runtime_error{"Nothing to compile!"};
+
+    std::set<Variable> variables;
+
+    for (Token const &token : tokens)
+        Builder::collect(token, variables);
+
+    for (Variable const &variable : variables)
+        this->inputs.push_back(variable.var);
+
+    Compiler compiler{.inputs = this->inputs};
+
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+        Builder::compile(compiler, tokens[i]);
+        compiler.instructions.push_back(
+            {OpCode::output, static_cast<std::uint32_t>(i), 0}
+        );
+    }
+
+    Sharer sharer{compiler.instructions};
+
+    this->instructions = std::move(sharer.code);
+    this->depth = measure(this->instructions);
+    this->registers = sharer.registers;
+    this->outputs = static_cast<std::uint32_t>(tokens.size());
+}
+
+std::string_view mlp::Program::variables() const { return this->inputs; }
+
+mlp::Program::operator ProgramView() const {
+    return {
+        this->instructions, this->inputs, this->depth, this->registers,
+        this->outputs
+    };
+}
+
+bool mlp::verify(ProgramView const program) {
+    // Every instruction pushes at most one entry or stores one register, so
+    // anything larger only makes evaluation allocate more than it needs.
+    if (program.depth > program.instructions.size() ||
+        program.registers > program.instructions.size() ||
+        program.outputs == 0)
+        return false;
+
+    std::size_t const builtins = builtin_names().size();
+    std::size_t size = 0;
+
+    for (auto const &[code, operand, constant] : program.instructions) {
+        std::size_t pops = 0;
+        bool push = false;
+
+        switch (code) {
+        case OpCode::constant:
+            push = true;
+            break;
+
+        case OpCode::load:
+            if (operand >= program.inputs.size())
+                return false;
+
+            push = true;
+            break;
+
+        case OpCode::add:
+        case OpCode::mul:
+            if (operand == 0)
+                return false;
+
+            pops = operand;
+            push = true;
+            break;
+
+        case OpCode::neg:
+        case OpCode::scale:
+        case OpCode::power:
+            pops = 1;
+            push = true;
+            break;
+
+        case OpCode::call:
+            if (operand >= builtins)
+                return false;
+
+            pops = 1;
+            push = true;
+            break;
+
+        case OpCode::pow:
+            pops = 2;
+            push = true;
+            break;
+
+        case OpCode::store:
+            if (operand >= program.registers || size == 0)
+                return false;
+
+            break;
+
+        case OpCode::fetch:
+            if (operand >= program.registers)
+                return false;
+
+            push = true;
+            break;
+
+        case OpCode::output:
+            if (operand >= program.outputs)
+                return false;
+
+            pops = 1;
+            break;
+
+        default:
+            return false;
+        }
+
+        if (pops > size)
+            return false;
+
+        size -= pops;
+
+        if (push && ++size > program.depth)
+            return false;
+    }
+
+    return size <= 1;
+}
+
+namespace {
+template <typename T>
+T run(mlp::ProgramView const program, std::span<T const> const inputs) {
+    if (inputs.size() < program.inputs.size())
+        throw std::runtime_error{"Missing value for variable!"};
+
+    std::array<T, 64> fixed{};
+    std::vector<T> dynamic;
+
+    T *stack = fixed.data();
+
+    // The registers live above the deepest the stack gets.
+    if (program.depth + program.registers > fixed.size()) {
+        dynamic.resize(program.depth + program.registers);
+        stack = dynamic.data();
+    }
+
+    T *registers = stack + program.depth;
+    T result{};
+    std::size_t size = 0;
+
+    for (auto const &[code, operand, constant] : program.instructions) {
+        T const value = static_cast<T>(constant);
+
+        switch (code) {
+        case mlp::OpCode::constant:
+            stack[size++] = value;
+            break;
+
+        case mlp::OpCode::load:
+            stack[size++] = value * inputs[operand];
+            break;
+
+        case mlp::OpCode::add:
+            for (std::uint32_t i = 1; i < operand; ++i)
+                stack[size - operand] += stack[size - operand + i];
+
+            size -= operand - 1;
+            break;
+
+        case mlp::OpCode::mul:
+            for (std::uint32_t i = 1; i < operand; ++i)
+                stack[size - operand] *= stack[size - operand + i];
+
+            size -= operand - 1;
+            break;
+
+        case mlp::OpCode::neg:
+            stack[size - 1] = -stack[size - 1];
+            break;
+
+        case mlp::OpCode::scale:
+            stack[size - 1] *= value;
+            break;
+
+        case mlp::OpCode::power:
+            if (constant == 2)
+                stack[size - 1] *= stack[size - 1];
+
+            else if (constant == -1)
+                stack[size - 1] = 1 / stack[size - 1];
+
+            else if (constant == 0.5)
+                stack[size - 1] = std::sqrt(stack[size - 1]);
+
+            else
+                stack[size - 1] = std::pow(stack[size - 1], value);
+
+            break;
+
+        case mlp::OpCode::pow:
+            stack[size - 2] = std::pow(stack[size - 2], stack[size - 1]);
+            --size;
+            break;
+
+        case mlp::OpCode::call:
+            stack[size - 1] = mlp::call_builtin(operand, stack[size - 1]);
+            break;
+
+        case mlp::OpCode::store:
+            registers[operand] = stack[size - 1];
+            break;
+
+        case mlp::OpCode::fetch:
+            stack[size++] = registers[operand];
+            break;
+
+        case mlp::OpCode::output:
+            if (operand == 0)
+                result = stack[size - 1];
+
+            --size;
+            break;
+        }
+    }
+
+    return size != 0 ? stack[0] : result;
+}
+
+template <typename T>
+void run(
+    mlp::ProgramView const program, std::span<T const> const inputs,
+    std::span<T> const results
+) {
+    constexpr std::size_t block = 256;
+
+    std::size_t const count = results.size() / program.outputs;
+
+    if (inputs.size() < program.inputs.size() * count)
+        throw std::runtime_error{"Missing value for variable!"};
+
+    std::vector<T> lanes(
+        std::max<std::size_t>(program.depth + program.registers, 1) * block
+    );
+
+    for (std::size_t begin = 0; begin < count; begin += block) {
+        std::size_t const width = std::min(block, count - begin);
+        std::size_t size = 0;
+
+        auto const lane = [&lanes](std::size_t const index) {
+            return lanes.data() + index * block;
+        };
+
+        for (auto const &[code, operand, constant] : program.instructions) {
+            T const value = static_cast<T>(constant);
+
+            switch (code) {
+            case mlp::OpCode::constant:
+                std::fill_n(lane(size++), width, value);
+                break;
+
+            case mlp::OpCode::load: {
+                T const *column = inputs.data() + operand * count + begin;
+                T *top = lane(size++);
+
+                for (std::size_t j = 0; j < width; ++j)
+                    top[j] = value * column[j];
+
+                break;
+            }
+
+            case mlp::OpCode::add: {
+                T *first = lane(size - operand);
+
+                for (std::uint32_t i = 1; i < operand; ++i) {
+                    T const *other = lane(size - operand + i);
+
+                    for (std::size_t j = 0; j < width; ++j)
+                        first[j] += other[j];
+                }
+
+                size -= operand - 1;
+                break;
+            }
+
+            case mlp::OpCode::mul: {
+                T *first = lane(size - operand);
+
+                for (std::uint32_t i = 1; i < operand; ++i) {
+                    T const *other = lane(size - operand + i);
+
+                    for (std::size_t j = 0; j < width; ++j)
+                        first[j] *= other[j];
+                }
+
+                size -= operand - 1;
+                break;
+            }
+
+            case mlp::OpCode::neg: {
+                T *top = lane(size - 1);
+
+                for (std::size_t j = 0; j < width; ++j)
+                    top[j] = -top[j];
+
+                break;
+            }
+
+            case mlp::OpCode::scale: {
+                T *top = lane(size - 1);
+
+                for (std::size_t j = 0; j < width; ++j)
+                    top[j] *= value;
+
+                break;
+            }
+
+            case mlp::OpCode::power: {
+                T *top = lane(size - 1);
+
+                if (constant == 2)
+                    for (std::size_t j = 0; j < width; ++j)
+                        top[j] *= top[j];
+
+                else if (constant == -1)
+                    for (std::size_t j = 0; j < width; ++j)
+                        top[j] = 1 / top[j];
+
+                else if (constant == 0.5)
+                    for (std::size_t j = 0; j < width; ++j)
+                        top[j] = std::sqrt(top[j]);
+
+                else
+                    for (std::size_t j = 0; j < width; ++j)
+                        top[j] = std::pow(top[j], value);
+
+                break;
+            }
+
+            case mlp::OpCode::pow: {
+                T *base = lane(size - 2);
+                T const *power = lane(size - 1);
+
+                for (std::size_t j = 0; j < width; ++j)
+                    base[j] = std::pow(base[j], power[j]);
+
+                --size;
+                break;
+            }
+
+            case mlp::OpCode::call: {
+                std::span const top{lane(size - 1), width};
+
+                mlp::call_builtin(operand, top, top);
+                break;
+            }
+
+            case mlp::OpCode::store:
+                std::copy_n(
+                    lane(size - 1), width, lane(program.depth + operand)
+                );
+                break;
+
+            case mlp::OpCode::fetch:
+                std::copy_n(
+                    lane(program.depth + operand), width, lane(size++)
+                );
+                break;
+
+            case mlp::OpCode::output:
+                std::copy_n(
+                    lane(--size), width,
+                    results.begin() + operand * count + begin
+                );
+                break;
+            }
+        }
+
+        if (size != 0)
+            std::copy_n(lane(0), width, results.begin() + begin);
+    }
+}
+} // namespace
+
+float mlp::evaluate(
+    ProgramView const program, std::span<float const> const inputs
+) {
+    return run(program, inputs);
+}
+
+mlp::Constant mlp::evaluate(
+    ProgramView const program, std::span<Constant const> const inputs
+) {
+    return run(program, inputs);
+}
+
+long double mlp::evaluate(
+    ProgramView const program, std::span<long double const> const inputs
+) {
+    return run(program, inputs);
+}
+
+mlp::Constant mlp::evaluate(
+    ProgramView const program, std::map<Variable, Constant> const &values
+) {
+    std::vector<Constant> inputs;
+    inputs.reserve(program.inputs.size());
+
+    for (char const variable : program.inputs) {
+        auto const value = values.find(Variable{variable});
+
+        if (value == values.end())
+            throw std::runtime_error{"Missing value for variable!"};
+
+        inputs.push_back(value->second);
+    }
+
+    return evaluate(program, inputs);
+}
+
+void mlp::evaluate(
+    ProgramView const program, std::span<float const> const inputs,
+    std::span<float> const results
+) {
+    run(program, inputs, results);
+}
+
+void mlp::evaluate(
+    ProgramView const program, std::span<Constant const> const inputs,
+    std::span<Constant> const results
+) {
+    run(program, inputs, results);
+}
+
+void mlp::evaluate(
+    ProgramView const program, std::span<long double const> const inputs,
+    std::span<long double> const results
+) {
+    run(program, inputs, results);
+}
+
+void mlp::evaluate(
+    ProgramView const program, std::span<Column const> const columns,
+    std::size_t const count, std::span<Constant> const results,
+    std::vector<Constant> &scratch
+) {
+    std::size_t const outputs = program.outputs;
+
+    if (columns.size() != program.inputs.size())
+        throw std::runtime_error{"Missing value for variable!"};
+
+    if (results.size() != count * outputs)
+        throw std::runtime_error{"Mismatched row counts!"};
+
+    // The input columns, followed by the output columns when there are
+    // several outputs to interleave into rows.
+    std::size_t const size = columns.size() * count;
+    scratch.resize(size + (outputs > 1 ? outputs * count : 0));
+
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        auto const &[source, stride, rows] = columns[i];
+        Constant *const column = scratch.data() + i * count;
+
+        if (!stride)
+            std::fill_n(column, count, *source);
+        else if (rows.empty())
+            for (std::size_t j = 0; j < count; ++j)
+                column[j] = source[j * stride];
+        else
+            for (std::size_t j = 0; j < count; ++j)
+                column[j] = source[rows[j] * stride];
+    }
+
+    std::span<Constant const> const inputs{scratch.data(), size};
+
+    if (outputs == 1) {
+        if (count == 1)
+            results[0] = evaluate(program, inputs);
+        else
+            evaluate(program, inputs, results);
+
+        return;
+    }
+
+    std::span<Constant> const staged{scratch.data() + size, outputs * count};
+    evaluate(program, inputs, staged);
+
+    for (std::size_t k = 0; k < outputs; ++k)
+        for (std::size_t j = 0; j < count; ++j)
+            results[j * outputs + k] = staged[k * count + j];
+}
+
+void mlp::parallel_blocks(
+    std::size_t const count,
+    std::function<void(std::size_t, std::size_t)> const &body
+) {
+    parallel_for(
+        (count + k_block - 1) / k_block,
+        [count, &body](std::size_t const block) {
+            std::size_t const begin = block * k_block;
+
+            body(begin, std::min(k_block, count - begin));
+        },
+        k_block
+    );
+}
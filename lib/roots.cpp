@@ -0,0 +1,195 @@
+#include "../include/roots.h"
+
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+// Evaluates program at x for the given rows of a block, gathering its input
+// columns from x and the parameter columns.
+class Gather final {
+    mlp::ProgramView program;
+    // Index into the parameter columns for every input, or -1 for x.
+    std::vector<std::ptrdiff_t> sources;
+    std::vector<mlp::Column> columns;
+    std::vector<mlp::Constant> scratch;
+
+  public:
+    Gather(
+        mlp::ProgramView const program, mlp::Variable const variable,
+        std::string_view const names
+    )
+        : program(program) {
+        for (char const input : program.inputs)
+            this->sources.push_back(
+                mlp::Variable{input} == variable
+                    ? -1
+                    : static_cast<std::ptrdiff_t>(names.find(input))
+            );
+    }
+
+    void operator()(
+        std::span<std::size_t const> const rows,
+        std::span<mlp::Constant const> const x,
+        std::span<mlp::Constant const> const parameters,
+        std::size_t const count, std::size_t const begin,
+        std::span<mlp::Constant> const results
+    ) {
+        this->columns.clear();
+
+        for (std::ptrdiff_t const source : this->sources)
+            this->columns.push_back(
+                {source < 0 ? x.data()
+                            : parameters.data() + source * count + begin,
+                 1, rows}
+            );
+
+        mlp::evaluate(
+            this->program, this->columns, rows.size(),
+            results.first(rows.size()), this->scratch
+        );
+    }
+};
+} // namespace
+
+mlp::RootFinder::RootFinder(Token const &token, Variable const variable)
+    : function(token), slope(simplified(derivative(token, variable, 1))),
+      variable(variable) {
+    for (char const input : this->function.variables())
+        if (!(Variable{input} == variable))
+            this->names += input;
+}
+
+std::string_view mlp::RootFinder::parameters() const { return this->names; }
+
+void mlp::RootFinder::solve(
+    std::span<Constant const> const lower,
+    std::span<Constant const> const upper,
+    std::span<Constant const> const parameters,
+    std::span<Constant> const roots, std::span<RootStatus> const status,
+    RootOptions const &options
+) const {
+    std::size_t const count = roots.size();
+
+    if (lower.size() != count || upper.size() != count ||
+        status.size() != count)
+        throw std::runtime_error{"Mismatched row counts!"};
+
+    if (parameters.size() < this->names.size() * count)
+        throw std::runtime_error{"Missing value for variable!"};
+
+    parallel_blocks(
+        count,
+        [&](std::size_t const begin, std::size_t const width) {
+            Gather function{this->function, this->variable, this->names};
+            Gather slope{this->slope, this->variable, this->names};
+
+            // negative and positive bound the root, with f below and above
+            // zero respectively; either may be the larger one.
+            std::vector<Constant> negative(
+                lower.begin() + begin, lower.begin() + begin + width
+            );
+            std::vector<Constant> positive(
+                upper.begin() + begin, upper.begin() + begin + width
+            );
+            std::vector<Constant> x(width);
+            std::vector<Constant> values(width);
+            std::vector<Constant> slopes(width);
+            std::vector<Constant> ends(width);
+
+            std::vector<std::size_t> rows(width);
+            std::vector<std::size_t> active;
+            active.reserve(width);
+
+            for (std::size_t i = 0; i < width; ++i)
+                rows[i] = i;
+
+            function(rows, negative, parameters, count, begin, values);
+            function(rows, positive, parameters, count, begin, ends);
+
+            auto const finish = [&](
+                                    std::size_t const row, Constant const root,
+                                    RootStatus const result
+                                ) {
+                roots[begin + row] = root;
+                status[begin + row] = result;
+            };
+
+            for (std::size_t const row : rows) {
+                bool const bracketed =
+                    std::isfinite(values[row]) && std::isfinite(ends[row]) &&
+                    std::signbit(values[row]) != std::signbit(ends[row]);
+
+                if (values[row] == 0) {
+                    finish(row, negative[row], RootStatus::converged);
+                } else if (ends[row] == 0) {
+                    finish(row, positive[row], RootStatus::converged);
+                } else if (!bracketed) {
+                    finish(
+                        row, std::numeric_limits<Constant>::quiet_NaN(),
+                        RootStatus::unbracketed
+                    );
+                } else {
+                    if (values[row] > 0)
+                        std::swap(negative[row], positive[row]);
+
+                    x[row] = (negative[row] + positive[row]) / 2;
+                    active.push_back(row);
+                }
+            }
+
+            for (std::uint32_t iteration = 0;
+                 iteration < options.iterations && !active.empty();
+                 ++iteration) {
+                function(active, x, parameters, count, begin, values);
+                slope(active, x, parameters, count, begin, slopes);
+
+                std::size_t remaining = 0;
+
+                for (std::size_t i = 0; i < active.size(); ++i) {
+                    std::size_t const row = active[i];
+                    Constant const value = values[i];
+
+                    if (value == 0) {
+                        finish(row, x[row], RootStatus::converged);
+
+                        continue;
+                    }
+
+                    (value < 0 ? negative : positive)[row] = x[row];
+
+                    auto const [low, high] =
+                        std::minmax(negative[row], positive[row]);
+                    Constant next = x[row] - value / slopes[i];
+
+                    if (!(next > low && next < high))
+                        next = (low + high) / 2;
+
+                    Constant const scale =
+                        options.tolerance * std::max(std::fabs(next), 1.0);
+
+                    if (std::fabs(next - x[row]) <= scale ||
+                        high - low <= scale) {
+                        finish(row, next, RootStatus::converged);
+
+                        continue;
+                    }
+
+                    x[row] = next;
+                    active[remaining++] = row;
+                }
+
+                active.resize(remaining);
+            }
+
+            for (std::size_t const row : active)
+                finish(row, x[row], RootStatus::exhausted);
+        }
+    );
+}
@@ -0,0 +1,430 @@
+#include "../include/sample.h"
+
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+
+namespace {
+// Samples passed to the sink at a time.
+constexpr std::size_t k_chunk = 256;
+constexpr mlp::Constant k_flat = 1e-12;
+
+struct Cell final {
+    std::array<std::uint32_t, 2> origin;
+    std::uint32_t size;
+    std::uint32_t level;
+    // Point indices of the corners, bit a set for the upper end along axis
+    // a, and of the centre.
+    std::array<std::uint32_t, 4> corners;
+    std::uint32_t centre;
+};
+
+mlp::Program compile(
+    mlp::Token const &token, std::vector<mlp::Variable> const &axes,
+    bool const slopes
+) {
+    if (axes.empty() || axes.size() > 2)
+        throw std::runtime_error{"Expected one or two axes!"};
+
+    if (!slopes)
+        return mlp::Program{token};
+
+    std::vector<mlp::Token> tokens{token};
+
+    for (mlp::Variable const &axis : axes)
+        tokens.push_back(simplified(derivative(token, axis, 1)));
+
+    return mlp::Program{std::span<mlp::Token const>{tokens}};
+}
+} // namespace
+
+mlp::Sampler::Sampler(
+    Token const &token, std::vector<Variable> axes, bool const slopes
+)
+    : axes(std::move(axes)), slopes(slopes),
+      program(compile(token, this->axes, slopes)) {
+    for (char const input : this->program.variables()) {
+        std::size_t const index =
+            std::ranges::find(this->axes, Variable{input}) - this->axes.begin();
+
+        if (index < this->axes.size()) {
+            this->slots.push_back(index);
+        } else {
+            this->slots.push_back(this->axes.size() + this->names.size());
+            this->names += input;
+        }
+    }
+}
+
+std::string_view mlp::Sampler::parameters() const { return this->names; }
+
+void mlp::Sampler::run(
+    std::span<Constant const> const parameters,
+    std::span<Constant const> const coordinates,
+    std::span<Constant> const results
+) const {
+    std::size_t const axes = this->axes.size();
+    std::size_t const count = coordinates.size() / axes;
+    ProgramView const program = this->program;
+
+    parallel_blocks(
+        count,
+        [&](std::size_t const begin, std::size_t const width) {
+            std::vector<Column> columns;
+            std::vector<Constant> scratch;
+
+            for (std::size_t const slot : this->slots)
+                columns.push_back(
+                    slot < axes
+                        ? Column{&coordinates[begin * axes + slot], axes}
+                        : Column{&parameters[slot - axes], 0}
+                );
+
+            evaluate(
+                program, columns, width,
+                results.subspan(
+                    begin * program.outputs, width * program.outputs
+                ),
+                scratch
+            );
+        }
+    );
+}
+
+void mlp::Sampler::refine(
+    std::span<Constant const> const lower,
+    std::span<Constant const> const upper,
+    std::span<Constant const> const parameters, SampleOptions const &options,
+    std::function<void(std::span<Constant const>)> const &sink
+) const {
+    std::size_t const axes = this->axes.size();
+    std::size_t const corners = std::size_t{1} << axes;
+    std::size_t const outputs = this->slopes ? 1 + axes : 1;
+
+    if (lower.size() != axes)
+        throw std::runtime_error{"Mismatched axis count!"};
+
+    if (parameters.size() < this->names.size())
+        throw std::runtime_error{"Missing value for variable!"};
+
+    if (options.initial == 0 || options.depth > 30 ||
+        std::uint64_t{options.initial} << (options.depth + 1) >
+            std::numeric_limits<std::uint32_t>::max())
+        throw std::runtime_error{"Sampling grid too fine!"};
+
+    // Points sit on a lattice fine enough to hold the centres of the
+    // smallest cells, which keeps shared corners and edges exact.
+    std::uint32_t const spacing = std::uint32_t{2} << options.depth;
+    std::uint32_t const resolution = options.initial * spacing;
+
+    std::vector<std::array<std::uint32_t, 2>> lattice;
+    std::unordered_map<std::uint64_t, std::uint32_t> indices;
+    std::vector<Constant> coordinates;
+    std::vector<Constant> results;
+
+    auto const position = [&](std::size_t const index, std::size_t const axis) {
+        return lower[axis] + (upper[axis] - lower[axis]) *
+                                 lattice[index][axis] / resolution;
+    };
+
+    auto const point = [&](std::array<std::uint32_t, 2> const at) {
+        auto const [entry, inserted] = indices.try_emplace(
+            std::uint64_t{at[1]} << 32 | at[0],
+            static_cast<std::uint32_t>(lattice.size())
+        );
+
+        if (inserted)
+            lattice.push_back(at);
+
+        return entry->second;
+    };
+
+    auto const cell = [&](
+                          std::array<std::uint32_t, 2> const origin,
+                          std::uint32_t const size, std::uint32_t const level
+                      ) {
+        Cell result{origin, size, level, {}, 0};
+
+        for (std::size_t k = 0; k < corners; ++k) {
+            std::array<std::uint32_t, 2> at = origin;
+
+            for (std::size_t a = 0; a < axes; ++a)
+                if (k >> a & 1)
+                    at[a] += size;
+
+            result.corners[k] = point(at);
+        }
+
+        std::array<std::uint32_t, 2> at = origin;
+
+        for (std::size_t a = 0; a < axes; ++a)
+            at[a] += size / 2;
+
+        result.centre = point(at);
+
+        return result;
+    };
+
+    Constant low = std::numeric_limits<Constant>::infinity();
+    Constant high = -low;
+    Constant threshold = 0;
+
+    // Evaluates the new points and widens the range the tolerance is
+    // relative to, so a coarse grid that misses the function's extent does
+    // not fix the threshold at a fraction of nothing.
+    auto const flush = [&] {
+        std::size_t const begin = results.size() / outputs;
+
+        coordinates.resize((lattice.size() - begin) * axes);
+        results.resize(lattice.size() * outputs);
+
+        for (std::size_t p = begin; p < lattice.size(); ++p)
+            for (std::size_t a = 0; a < axes; ++a)
+                coordinates[(p - begin) * axes + a] = position(p, a);
+
+        this->run(
+            parameters, coordinates,
+            std::span{results}.subspan(begin * outputs)
+        );
+
+        for (std::size_t p = begin; p < lattice.size(); ++p)
+            if (Constant const value = results[p * outputs];
+                std::isfinite(value)) {
+                low = std::min(low, value);
+                high = std::max(high, value);
+            }
+
+        // Samples equal up to rounding leave the tolerance absolute.
+        Constant const magnitude =
+            std::max({1.0, std::fabs(low), std::fabs(high)});
+
+        threshold = options.tolerance *
+                    (high - low > k_flat * magnitude ? high - low : 1);
+    };
+
+    std::vector<Cell> cells;
+    std::vector<Cell> next;
+
+    for (std::uint32_t j = 0; j < (axes == 2 ? options.initial : 1); ++j)
+        for (std::uint32_t i = 0; i < options.initial; ++i)
+            cells.push_back(cell({i * spacing, j * spacing}, spacing, 0));
+
+    flush();
+
+    auto const rough = [&](Cell const &current) {
+        Constant const value = results[current.centre * outputs];
+        bool const finite = std::isfinite(value);
+        Constant average = 0;
+
+        // Split across the edge of the domain or a singularity.
+        for (std::size_t k = 0; k < corners; ++k) {
+            Constant const corner = results[current.corners[k] * outputs];
+
+            if (std::isfinite(corner) != finite)
+                return true;
+
+            average += corner;
+        }
+
+        if (!finite)
+            return false;
+
+        if (std::fabs(value - average / corners) > threshold)
+            return true;
+
+        if (!this->slopes)
+            return false;
+
+        for (std::size_t k = 0; k < corners; ++k) {
+            Constant const *corner =
+                results.data() + current.corners[k] * outputs;
+            Constant predicted = corner[0];
+
+            for (std::size_t a = 0; a < axes; ++a)
+                predicted += corner[1 + a] * (k >> a & 1 ? -1 : 1) *
+                             (upper[a] - lower[a]) * (current.size / 2) /
+                             resolution;
+
+            if (std::fabs(predicted - value) > threshold)
+                return true;
+        }
+
+        return false;
+    };
+
+    while (!cells.empty()) {
+        next.clear();
+
+        for (Cell const &current : cells) {
+            // A split adds at most two points per corner.
+            if (current.level == options.depth ||
+                lattice.size() + 2 * corners > options.limit ||
+                !rough(current))
+                continue;
+
+            std::uint32_t const half = current.size / 2;
+
+            for (std::size_t k = 0; k < corners; ++k) {
+                std::array<std::uint32_t, 2> origin = current.origin;
+
+                for (std::size_t a = 0; a < axes; ++a)
+                    if (k >> a & 1)
+                        origin[a] += half;
+
+                next.push_back(cell(origin, half, current.level + 1));
+            }
+        }
+
+        std::swap(cells, next);
+        flush();
+    }
+
+    std::vector<std::uint32_t> order(lattice.size());
+
+    for (std::size_t p = 0; p < order.size(); ++p)
+        order[p] = static_cast<std::uint32_t>(p);
+
+    std::ranges::sort(order, [&lattice](auto const lhs, auto const rhs) {
+        return std::tie(lattice[lhs][1], lattice[lhs][0]) <
+               std::tie(lattice[rhs][1], lattice[rhs][0]);
+    });
+
+    std::vector<Constant> chunk;
+
+    for (std::size_t begin = 0; begin < order.size(); begin += k_chunk) {
+        chunk.clear();
+
+        for (std::size_t p = begin;
+             p < std::min(begin + k_chunk, order.size()); ++p) {
+            for (std::size_t a = 0; a < axes; ++a)
+                chunk.push_back(position(order[p], a));
+
+            chunk.push_back(results[order[p] * outputs]);
+        }
+
+        sink(chunk);
+    }
+}
+
+void mlp::Sampler::curve(
+    Constant const lower, Constant const upper,
+    std::span<Constant const> const parameters,
+    std::function<void(std::span<Sample const>)> const &sink,
+    SampleOptions const &options
+) const {
+    std::vector<Sample> samples;
+
+    this->refine(
+        {&lower, 1}, {&upper, 1}, parameters, options,
+        [&sink, &samples](std::span<Constant const> const chunk) {
+            samples.clear();
+
+            for (std::size_t i = 0; i < chunk.size(); i += 2)
+                samples.push_back({chunk[i], chunk[i + 1]});
+
+            sink(samples);
+        }
+    );
+}
+
+std::size_t mlp::Sampler::curve(
+    Constant const lower, Constant const upper,
+    std::span<Constant const> const parameters,
+    std::span<Sample> const samples, SampleOptions const &options
+) const {
+    std::size_t count = 0;
+
+    this->curve(
+        lower, upper, parameters,
+        [&count, samples](std::span<Sample const> const chunk) {
+            for (Sample const &sample : chunk)
+                if (count++ < samples.size())
+                    samples[count - 1] = sample;
+        },
+        options
+    );
+
+    return count;
+}
+
+void mlp::Sampler::curve(
+    Constant const lower, Constant const upper,
+    std::span<Constant const> const parameters, std::ostream &output,
+    SampleOptions const &options
+) const {
+    this->curve(
+        lower, upper, parameters,
+        [&output](std::span<Sample const> const chunk) {
+            output.write(
+                reinterpret_cast<char const *>(chunk.data()),
+                static_cast<std::streamsize>(chunk.size_bytes())
+            );
+        },
+        options
+    );
+}
+
+void mlp::Sampler::surface(
+    std::array<Constant, 2> const lower, std::array<Constant, 2> const upper,
+    std::span<Constant const> const parameters,
+    std::function<void(std::span<SurfaceSample const>)> const &sink,
+    SampleOptions const &options
+) const {
+    std::vector<SurfaceSample> samples;
+
+    this->refine(
+        lower, upper, parameters, options,
+        [&sink, &samples](std::span<Constant const> const chunk) {
+            samples.clear();
+
+            for (std::size_t i = 0; i < chunk.size(); i += 3)
+                samples.push_back({chunk[i], chunk[i + 1], chunk[i + 2]});
+
+            sink(samples);
+        }
+    );
+}
+
+std::size_t mlp::Sampler::surface(
+    std::array<Constant, 2> const lower, std::array<Constant, 2> const upper,
+    std::span<Constant const> const parameters,
+    std::span<SurfaceSample> const samples, SampleOptions const &options
+) const {
+    std::size_t count = 0;
+
+    this->surface(
+        lower, upper, parameters,
+        [&count, samples](std::span<SurfaceSample const> const chunk) {
+            for (SurfaceSample const &sample : chunk)
+                if (count++ < samples.size())
+                    samples[count - 1] = sample;
+        },
+        options
+    );
+
+    return count;
+}
+
+void mlp::Sampler::surface(
+    std::array<Constant, 2> const lower, std::array<Constant, 2> const upper,
+    std::span<Constant const> const parameters, std::ostream &output,
+    SampleOptions const &options
+) const {
+    this->surface(
+        lower, upper, parameters,
+        [&output](std::span<SurfaceSample const> const chunk) {
+            output.write(
+                reinterpret_cast<char const *>(chunk.data()),
+                static_cast<std::streamsize>(chunk.size_bytes())
+            );
+        },
+        options
+    );
+}
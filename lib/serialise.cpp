@@ -0,0 +1,427 @@
+#include "../include/serialise.h"
+
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+#include "../include/variable.h"
+
+#include <algorithm>
+#include <bit>
+#include <sstream>
+#include <utility>
+
+namespace {
+enum class Tag : std::uint8_t {
+    constant,
+    variable,
+    function,
+    term,
+    terms,
+    expression,
+    reference
+};
+
+constexpr std::string_view k_magic = "MLPB";
+// Nesting beyond this is taken for a corrupt stream rather than risk the
+// recursion running out of stack.
+constexpr std::size_t k_depth = 2048;
+// References let a short stream stand for an exponentially larger tree, so
+// decoding stops once it has produced this many nodes.
+constexpr std::uint64_t k_nodes = std::uint64_t{1} << 20;
+
+void put_byte(std::string &buffer, std::uint8_t const byte) {
+    buffer.push_back(static_cast<char>(byte));
+}
+
+void put_varint(std::string &buffer, std::uint64_t value) {
+    while (value >= 0x80) {
+        put_byte(buffer, static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+
+    put_byte(buffer, static_cast<std::uint8_t>(value));
+}
+
+void put_u64(std::string &buffer, std::uint64_t const value) {
+    for (std::size_t i = 0; i < 8; ++i)
+        put_byte(buffer, static_cast<std::uint8_t>(value >> i * 8));
+}
+
+void put_constant(std::string &buffer, mlp::Constant const value) {
+    put_u64(buffer, std::bit_cast<std::uint64_t>(value));
+}
+
+std::uint8_t
+get_byte(std::span<std::byte const> const buffer, std::size_t &position) {
+    if (position >= buffer.size())
+        throw std::runtime_error{"Malformed binary token!"};
+
+    return std::to_integer<std::uint8_t>(buffer[position++]);
+}
+
+std::uint64_t
+get_varint(std::span<std::byte const> const buffer, std::size_t &position) {
+    std::uint64_t value = 0;
+
+    for (std::uint32_t shift = 0; shift < 64; shift += 7) {
+        std::uint8_t const byte = get_byte(buffer, position);
+
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80))
+            return value;
+    }
+
+    throw std::runtime_error{"Malformed binary token!"};
+}
+
+// Every child takes at least a byte, so a larger count is corrupt and must
+// not reach reserve.
+std::uint64_t
+get_count(std::span<std::byte const> const buffer, std::size_t &position) {
+    std::uint64_t const count = get_varint(buffer, position);
+
+    if (count > buffer.size() - position)
+        throw std::runtime_error{"Malformed binary token!"};
+
+    return count;
+}
+
+mlp::Constant
+get_constant(std::span<std::byte const> const buffer, std::size_t &position) {
+    std::uint64_t value = 0;
+
+    for (std::size_t i = 0; i < 8; ++i)
+        value |= static_cast<std::uint64_t>(get_byte(buffer, position))
+                 << i * 8;
+
+    return std::bit_cast<mlp::Constant>(value);
+}
+
+void put_key(std::string &key, std::uint64_t const value) {
+    key.append(reinterpret_cast<char const *>(&value), sizeof value);
+}
+} // namespace
+
+mlp::BinaryWriter::BinaryWriter(std::ostream &output) : output(output) {
+    std::string header{k_magic};
+    header.push_back(static_cast<char>(version & 0xFF));
+    header.push_back(static_cast<char>(version >> 8));
+
+    this->output.write(
+        header.data(), static_cast<std::streamsize>(header.size())
+    );
+    this->offset = header.size();
+}
+
+std::uint64_t mlp::BinaryWriter::intern(Token const &token) {
+    std::string key;
+    put_byte(key, static_cast<std::uint8_t>(token.index()));
+
+    std::visit(
+        [this, &key]<typename T>(T const &var) {
+            if constexpr (std::is_same_v<T, Constant>) {
+                put_key(key, std::bit_cast<std::uint64_t>(var));
+            } else if constexpr (std::is_same_v<T, Variable>) {
+                put_key(key, std::bit_cast<std::uint64_t>(var.coefficient));
+                key.push_back(var.var);
+            } else if constexpr (std::is_same_v<T, Function>) {
+                key += var.function;
+                key.push_back('\0');
+
+                for (Token const &parameter : var.parameters)
+                    put_key(key, this->intern(parameter));
+            } else if constexpr (std::is_same_v<T, Term>) {
+                put_key(key, std::bit_cast<std::uint64_t>(var.coefficient));
+                put_key(key, this->intern(*var.base));
+                put_key(key, this->intern(*var.power));
+            } else if constexpr (std::is_same_v<T, Terms>) {
+                put_key(key, std::bit_cast<std::uint64_t>(var.coefficient));
+
+                for (Token const &term : var.terms)
+                    put_key(key, this->intern(term));
+            } else {
+                for (auto const &[sign, term] : var.tokens) {
+                    key.push_back(sign == Sign::pos ? '+' : '-');
+                    put_key(key, this->intern(term));
+                }
+            }
+        },
+        token
+    );
+
+    auto const [shape, _] = this->shapes.try_emplace(
+        std::move(key), static_cast<std::uint64_t>(this->shapes.size())
+    );
+
+    this->ids[&token] = shape->second;
+
+    return shape->second;
+}
+
+void mlp::BinaryWriter::encode(std::string &buffer, Token const &token) {
+    std::uint64_t const position = this->offset + buffer.size();
+
+    if (!std::holds_alternative<Constant>(token) &&
+        !std::holds_alternative<Variable>(token)) {
+        std::uint64_t const id = this->ids.at(&token);
+
+        if (auto const emitted = this->emitted.find(id);
+            emitted != this->emitted.end()) {
+            put_byte(buffer, std::to_underlying(Tag::reference));
+            put_varint(buffer, position - emitted->second);
+
+            return;
+        }
+
+        this->emitted[id] = position;
+    }
+
+    put_byte(buffer, static_cast<std::uint8_t>(token.index()));
+
+    std::visit(
+        [this, &buffer]<typename T>(T const &var) {
+            if constexpr (std::is_same_v<T, Constant>) {
+                put_constant(buffer, var);
+            } else if constexpr (std::is_same_v<T, Variable>) {
+                put_constant(buffer, var.coefficient);
+                put_byte(buffer, static_cast<std::uint8_t>(var.var));
+            } else if constexpr (std::is_same_v<T, Function>) {
+                auto const [function, is_new] = this->functions.try_emplace(
+                    var.function,
+                    static_cast<std::uint64_t>(this->functions.size())
+                );
+
+                put_varint(buffer, function->second << 1 | is_new);
+
+                if (is_new) {
+                    put_varint(buffer, var.function.size());
+                    buffer += var.function;
+                }
+
+                put_varint(buffer, var.parameters.size());
+
+                for (Token const &parameter : var.parameters)
+                    this->encode(buffer, parameter);
+            } else if constexpr (std::is_same_v<T, Term>) {
+                put_constant(buffer, var.coefficient);
+                this->encode(buffer, *var.base);
+                this->encode(buffer, *var.power);
+            } else if constexpr (std::is_same_v<T, Terms>) {
+                put_constant(buffer, var.coefficient);
+                put_varint(buffer, var.terms.size());
+
+                for (Token const &term : var.terms)
+                    this->encode(buffer, term);
+            } else {
+                put_varint(buffer, var.tokens.size());
+
+                for (auto const &[sign, term] : var.tokens) {
+                    put_byte(buffer, std::to_underlying(sign));
+                    this->encode(buffer, term);
+                }
+            }
+        },
+        token
+    );
+}
+
+mlp::BinaryWriter &mlp::BinaryWriter::operator<<(Token const &token) {
+    this->intern(token);
+
+    std::string buffer;
+    this->encode(buffer, token);
+
+    this->ids.clear();
+
+    this->output.write(
+        buffer.data(), static_cast<std::streamsize>(buffer.size())
+    );
+    this->offset += buffer.size();
+
+    return *this;
+}
+
+mlp::BinaryReader::BinaryReader(std::span<std::byte const> const buffer)
+    : buffer(buffer) {
+    if (buffer.size() < k_magic.size() + 2 ||
+        !std::ranges::equal(
+            buffer.first(k_magic.size()), k_magic,
+            [](std::byte const lhs, char const rhs) -> bool {
+                return std::to_integer<char>(lhs) == rhs;
+            }
+        ))
+        throw std::runtime_error{"Not a binary token stream!"};
+
+    this->offset = k_magic.size();
+
+    std::uint16_t version = get_byte(this->buffer, this->offset);
+    version |= get_byte(this->buffer, this->offset) << 8;
+
+    if (version != BinaryWriter::version)
+        throw std::runtime_error{"Unsupported binary token version!"};
+}
+
+bool mlp::BinaryReader::empty() const {
+    return this->offset >= this->buffer.size();
+}
+
+mlp::Token
+mlp::BinaryReader::decode(std::size_t &position, std::size_t const depth) {
+    if (depth > k_depth)
+        throw std::runtime_error{"Malformed binary token!"};
+
+    std::size_t const start = position;
+    Token token = this->node(position, depth);
+    this->finished.insert(start);
+
+    return token;
+}
+
+mlp::Token
+mlp::BinaryReader::node(std::size_t &position, std::size_t const depth) {
+    std::size_t const start = position;
+
+    if (++this->nodes > k_nodes)
+        throw std::runtime_error{"Binary token is too large!"};
+
+    switch (static_cast<Tag>(get_byte(this->buffer, position))) {
+    case Tag::constant:
+        return get_constant(this->buffer, position);
+
+    case Tag::variable: {
+        Constant const coefficient = get_constant(this->buffer, position);
+
+        return Variable{
+            coefficient, static_cast<char>(get_byte(this->buffer, position))
+        };
+    }
+
+    case Tag::function: {
+        std::uint64_t const header = get_varint(this->buffer, position);
+        std::uint64_t const id = header >> 1;
+
+        if (header & 1) {
+            std::uint64_t const length = get_varint(this->buffer, position);
+
+            if (length > this->buffer.size() - position)
+                throw std::runtime_error{"Malformed binary token!"};
+
+            if (id == this->functions.size())
+                this->functions.emplace_back(
+                    reinterpret_cast<char const *>(&this->buffer[position]),
+                    length
+                );
+
+            position += length;
+        }
+
+        if (id >= this->functions.size())
+            throw std::runtime_error{"Malformed binary token!"};
+
+        std::uint64_t const count = get_count(this->buffer, position);
+
+        std::vector<Token> parameters;
+        parameters.reserve(count);
+
+        for (std::uint64_t i = 0; i < count; ++i)
+            parameters.push_back(this->decode(position, depth + 1));
+
+        return Function{this->functions[id], std::move(parameters)};
+    }
+
+    case Tag::term: {
+        Constant const coefficient = get_constant(this->buffer, position);
+        Token base = this->decode(position, depth + 1);
+        Token power = this->decode(position, depth + 1);
+
+        return Term{coefficient, std::move(base), std::move(power)};
+    }
+
+    case Tag::terms: {
+        Terms terms;
+        terms.coefficient = get_constant(this->buffer, position);
+
+        std::uint64_t const count = get_count(this->buffer, position);
+        terms.terms.reserve(count);
+
+        for (std::uint64_t i = 0; i < count; ++i)
+            terms.terms.push_back(this->decode(position, depth + 1));
+
+        return terms;
+    }
+
+    case Tag::expression: {
+        Expression expression;
+
+        std::uint64_t const count = get_count(this->buffer, position);
+        expression.tokens.reserve(count);
+
+        for (std::uint64_t i = 0; i < count; ++i) {
+            std::uint8_t const sign = get_byte(this->buffer, position);
+
+            if (sign > std::to_underlying(Sign::neg))
+                throw std::runtime_error{"Malformed binary token!"};
+
+            expression.tokens.emplace_back(
+                static_cast<Sign>(sign), this->decode(position, depth + 1)
+            );
+        }
+
+        return expression;
+    }
+
+    case Tag::reference: {
+        std::uint64_t const distance = get_varint(this->buffer, position);
+
+        if (!distance || distance > start ||
+            !this->finished.contains(start - distance))
+            throw std::runtime_error{"Malformed binary token!"};
+
+        std::size_t target = start - distance;
+        auto entry = this->referenced.find(target);
+
+        if (entry == this->referenced.end()) {
+            std::uint64_t const before = this->nodes;
+            auto token =
+                std::make_unique<Token>(this->decode(target, depth + 1));
+
+            entry = this->referenced
+                        .emplace(
+                            start - distance,
+                            Decoded{std::move(token), this->nodes - before}
+                        )
+                        .first;
+        } else if ((this->nodes += entry->second.nodes) > k_nodes) {
+            throw std::runtime_error{"Binary token is too large!"};
+        }
+
+        return *entry->second.token;
+    }
+    }
+
+    throw std::runtime_error{"Malformed binary token!"};
+}
+
+mlp::BinaryReader &mlp::BinaryReader::operator>>(Token &token) {
+    token = this->decode(this->offset, 0);
+
+    return *this;
+}
+
+std::string mlp::serialise(Token const &token) {
+    std::stringstream stream;
+
+    BinaryWriter{stream} << token;
+
+    return stream.str();
+}
+
+mlp::Token mlp::deserialise(std::string_view const buffer) {
+    Token token;
+
+    BinaryReader{std::as_bytes(std::span{buffer})} >> token;
+
+    return token;
+}
@@ -0,0 +1,821 @@
+#include "../include/server.h"
+
+#include "../include/cancellation.h"
+#include "../include/counters.h"
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/program.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+#include "../include/variable.h"
+
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cerrno>
+#include <charconv>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+// Highest derivative order and longest timeout, in milliseconds, a request
+// may ask for.
+constexpr double k_order = 64;
+constexpr double k_timeout = 24 * 60 * 60 * 1000;
+
+constexpr std::string_view k_too_long =
+    "{\"id\": null, \"error\": \"Request too long!\"}\n";
+constexpr std::string_view k_too_many =
+    "{\"id\": null, \"error\": \"Too many connections!\"}\n";
+
+// A client that stops reading its responses makes send() block once the
+// socket buffer is full. Sends give up after the server's write timeout and
+// shut the connection down, so that one client cannot hold every worker.
+class Connection final {
+    int socket;
+    std::mutex writer;
+    bool broken{false};
+
+  public:
+    Connection(int const socket, double const timeout) : socket(socket) {
+        if (timeout <= 0)
+            return;
+
+        auto const microseconds = static_cast<long long>(timeout * 1000);
+        timeval const limit{
+            .tv_sec = static_cast<time_t>(microseconds / 1000000),
+            .tv_usec = static_cast<suseconds_t>(microseconds % 1000000)
+        };
+
+        ::setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &limit, sizeof limit);
+    }
+
+    Connection(Connection const &) = delete;
+
+    Connection &operator=(Connection const &) = delete;
+
+    ~Connection() { ::close(this->socket); }
+
+    [[nodiscard]] int descriptor() const { return this->socket; }
+
+    void send(std::string_view data) {
+        std::lock_guard const lock{this->writer};
+
+        while (!data.empty() && !this->broken) {
+            ssize_t const written =
+                ::send(this->socket, data.data(), data.size(), MSG_NOSIGNAL);
+
+            if (written <= 0) {
+                if (written < 0 && errno == EINTR)
+                    continue;
+
+                // Also wakes the reader, which stops queueing requests.
+                this->broken = true;
+                ::shutdown(this->socket, SHUT_RDWR);
+
+                return;
+            }
+
+            data.remove_prefix(static_cast<std::size_t>(written));
+        }
+    }
+};
+
+struct Job final {
+    std::shared_ptr<Connection> connection;
+    std::string line;
+};
+
+class Queue final {
+    std::mutex mutex;
+    std::condition_variable readable;
+    std::condition_variable writable;
+    std::deque<Job> jobs;
+    std::size_t capacity;
+    bool closed{false};
+
+  public:
+    explicit Queue(std::size_t const capacity)
+        : capacity(std::max<std::size_t>(capacity, 1)) {}
+
+    bool push(Job job) {
+        std::unique_lock lock{this->mutex};
+
+        this->writable.wait(lock, [this] {
+            return this->closed || this->jobs.size() < this->capacity;
+        });
+
+        if (this->closed)
+            return false;
+
+        this->jobs.push_back(std::move(job));
+        this->readable.notify_one();
+
+        return true;
+    }
+
+    std::optional<Job> pop() {
+        std::unique_lock lock{this->mutex};
+
+        this->readable.wait(lock, [this] {
+            return this->closed || !this->jobs.empty();
+        });
+
+        if (this->jobs.empty())
+            return std::nullopt;
+
+        Job job = std::move(this->jobs.front());
+        this->jobs.pop_front();
+        this->writable.notify_one();
+
+        return job;
+    }
+
+    void close() {
+        {
+            std::lock_guard const lock{this->mutex};
+            this->closed = true;
+        }
+
+        this->readable.notify_all();
+        this->writable.notify_all();
+    }
+
+    [[nodiscard]] std::size_t size() {
+        std::lock_guard const lock{this->mutex};
+
+        return this->jobs.size();
+    }
+};
+
+// Evicts by the clock algorithm: a hit marks its entry, and when the cache
+// is full the hand sweeps the slots, clearing marks, and replaces the first
+// unmarked one. Hits only need the shared lock.
+template <typename T> class Cache final {
+    struct Slot final {
+        std::string key;
+        std::shared_ptr<T const> value;
+        std::atomic<bool> used{false};
+    };
+
+    std::shared_mutex mutex;
+    // A deque so that slots stay put as it grows.
+    std::deque<Slot> slots;
+    std::unordered_map<std::string, std::size_t> index;
+    std::size_t hand{0};
+    std::size_t capacity;
+
+  public:
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+
+    explicit Cache(std::size_t const capacity)
+        : capacity(std::max<std::size_t>(capacity, 1)) {}
+
+    template <typename Make>
+    std::shared_ptr<T const> get(std::string const &key, Make const &make) {
+        {
+            std::shared_lock const lock{this->mutex};
+
+            if (auto const entry = this->index.find(key);
+                entry != this->index.end()) {
+                Slot &slot = this->slots[entry->second];
+                slot.used.store(true, std::memory_order_relaxed);
+                this->hits.fetch_add(1, std::memory_order_relaxed);
+
+                return slot.value;
+            }
+        }
+
+        this->misses.fetch_add(1, std::memory_order_relaxed);
+
+        auto value = std::make_shared<T const>(make());
+
+        std::lock_guard const lock{this->mutex};
+
+        if (auto const entry = this->index.find(key);
+            entry != this->index.end())
+            return this->slots[entry->second].value;
+
+        if (this->slots.size() < this->capacity) {
+            this->index.emplace(key, this->slots.size());
+            Slot &slot = this->slots.emplace_back();
+            slot.key = key;
+            slot.value = std::move(value);
+
+            return slot.value;
+        }
+
+        while (this->slots[this->hand].used.exchange(
+            false, std::memory_order_relaxed
+        ))
+            this->hand = (this->hand + 1) % this->slots.size();
+
+        Slot &slot = this->slots[this->hand];
+        this->index.erase(slot.key);
+        this->index.emplace(key, this->hand);
+        slot.key = key;
+        slot.value = std::move(value);
+        this->hand = (this->hand + 1) % this->slots.size();
+
+        return slot.value;
+    }
+
+    [[nodiscard]] std::size_t size() {
+        std::shared_lock const lock{this->mutex};
+
+        return this->slots.size();
+    }
+};
+
+void quote(std::string &output, std::string_view const text) {
+    output += '"';
+
+    for (char const c : text) {
+        if (c == '"' || c == '\\') {
+            output += '\\';
+            output += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escape[8];
+            std::snprintf(escape, sizeof escape, "\\u%04x", c);
+            output += escape;
+        } else {
+            output += c;
+        }
+    }
+
+    output += '"';
+}
+
+void number(std::string &output, double const value) {
+    char buffer[32];
+    auto const end = std::to_chars(buffer, buffer + sizeof buffer, value).ptr;
+
+    output.append(buffer, end);
+}
+
+struct Request final {
+    std::string id{"null"};
+    std::string op;
+    std::string expression;
+    char variable{'x'};
+    std::uint32_t order{1};
+    std::optional<double> timeout;
+    std::map<mlp::Variable, mlp::Constant> values;
+};
+
+class Reader final {
+    std::string_view text;
+    std::size_t position{0};
+
+    [[noreturn]] static void fail() {
+        throw std::runtime_error{"Malformed request!"};
+    }
+
+    void skip() {
+        while (this->position < this->text.size() &&
+               std::isspace(
+                   static_cast<unsigned char>(this->text[this->position])
+               ))
+            ++this->position;
+    }
+
+    char peek() {
+        this->skip();
+
+        return this->position < this->text.size() ? this->text[this->position]
+                                                  : '\0';
+    }
+
+    void expect(char const c) {
+        if (this->peek() != c)
+            fail();
+
+        ++this->position;
+    }
+
+    std::string string() {
+        this->expect('"');
+
+        std::string result;
+
+        while (this->position < this->text.size()) {
+            char const c = this->text[this->position++];
+
+            if (c == '"')
+                return result;
+
+            if (c != '\\') {
+                result += c;
+
+                continue;
+            }
+
+            if (this->position >= this->text.size())
+                fail();
+
+            switch (char const escape = this->text[this->position++]) {
+            case 'n':
+                result += '\n';
+                break;
+
+            case 't':
+                result += '\t';
+                break;
+
+            case 'r':
+                result += '\r';
+                break;
+
+            case 'b':
+                result += '\b';
+                break;
+
+            case 'f':
+                result += '\f';
+                break;
+
+            case 'u': {
+                unsigned code = 0;
+                auto const *begin = this->text.data() + this->position;
+
+                if (this->position + 4 > this->text.size() ||
+                    std::from_chars(begin, begin + 4, code, 16).ptr !=
+                        begin + 4 ||
+                    code > 0x7f)
+                    fail();
+
+                result += static_cast<char>(code);
+                this->position += 4;
+                break;
+            }
+
+            default:
+                result += escape;
+            }
+        }
+
+        fail();
+    }
+
+    double number() {
+        this->skip();
+
+        double value = 0;
+        auto const *begin = this->text.data() + this->position;
+        auto const *const last = this->text.data() + this->text.size();
+        auto const [end, error] = std::from_chars(begin, last, value);
+
+        // from_chars also takes inf and nan, which are not JSON.
+        if (error != std::errc{} || !std::isfinite(value))
+            fail();
+
+        this->position += end - begin;
+
+        return value;
+    }
+
+    std::string_view value() {
+        std::size_t const begin = (this->skip(), this->position);
+
+        if (char const c = this->peek(); c == '"')
+            this->string();
+
+        else if (c == '{' || c == '[')
+            for (std::size_t depth = 0; this->position < this->text.size();) {
+                char const d = this->text[this->position];
+
+                if (d == '"') {
+                    this->string();
+
+                    continue;
+                }
+
+                ++this->position;
+
+                if (d == '{' || d == '[')
+                    ++depth;
+
+                else if ((d == '}' || d == ']') && !--depth)
+                    break;
+            }
+
+        else
+            while (this->position < this->text.size() &&
+                   !std::string_view{",}] \t\r\n"}.contains(
+                       this->text[this->position]
+                   ))
+                ++this->position;
+
+        if (begin == this->position)
+            fail();
+
+        return this->text.substr(begin, this->position - begin);
+    }
+
+  public:
+    explicit Reader(std::string_view const text) : text(text) {}
+
+    Request request() {
+        Request request;
+
+        this->expect('{');
+
+        for (bool first = true; this->peek() != '}'; first = false) {
+            if (!first)
+                this->expect(',');
+
+            std::string const key = this->string();
+            this->expect(':');
+
+            if (key == "id") {
+                // The id is echoed into the response, so it is read as one
+                // of the forms that serialise back to valid JSON.
+                std::string id;
+
+                if (this->peek() == '"')
+                    quote(id, this->string());
+                else
+                    ::number(id, this->number());
+
+                request.id = std::move(id);
+            } else if (key == "op") {
+                request.op = this->string();
+            } else if (key == "expression") {
+                request.expression = this->string();
+            } else if (key == "variable") {
+                std::string const variable = this->string();
+
+                if (variable.size() != 1)
+                    fail();
+
+                request.variable = variable[0];
+            } else if (key == "order") {
+                double const order = this->number();
+
+                if (!(order >= 0 && order <= k_order) ||
+                    order != std::floor(order))
+                    fail();
+
+                request.order = static_cast<std::uint32_t>(order);
+            } else if (key == "timeout") {
+                double const timeout = this->number();
+
+                if (!(timeout >= 0 && timeout <= k_timeout))
+                    fail();
+
+                request.timeout = timeout;
+            } else if (key == "values") {
+                this->expect('{');
+
+                for (bool next = false; this->peek() != '}'; next = true) {
+                    if (next)
+                        this->expect(',');
+
+                    std::string const name = this->string();
+                    this->expect(':');
+
+                    if (name.size() != 1)
+                        fail();
+
+                    request.values[mlp::Variable{name[0]}] = this->number();
+                }
+
+                this->expect('}');
+            } else {
+                this->value();
+            }
+        }
+
+        this->expect('}');
+
+        return request;
+    }
+};
+
+} // namespace
+
+struct mlp::Server::State final {
+    std::filesystem::path path;
+    ServerOptions options;
+    int listener{-1};
+    std::atomic<bool> running{true};
+
+    Queue queue;
+    Cache<Token> parsed;
+    Cache<Token> simplified;
+    Cache<std::optional<Program>> compiled;
+
+    std::mutex mutex;
+    std::list<std::pair<std::weak_ptr<Connection>, std::jthread>> readers;
+    std::vector<std::jthread> workers;
+
+    State(std::filesystem::path path, ServerOptions const &options)
+        : path(std::move(path)), options(options), queue(options.queue),
+          parsed(options.cache), simplified(options.cache),
+          compiled(options.cache) {}
+
+    std::shared_ptr<Token const> parse(std::string const &expression) {
+        return this->parsed.get(expression, [&expression] {
+            return tokenise(expression);
+        });
+    }
+
+    std::string handle(std::string_view line);
+
+    std::string stats();
+
+    void read(std::shared_ptr<Connection> const &connection);
+
+    void work();
+};
+
+std::string mlp::Server::State::handle(std::string_view const line) {
+    Request request;
+    std::string response{"{\"id\": "};
+
+    try {
+        request = Reader{line}.request();
+        response += request.id;
+
+        std::optional<cancellation::Scope> scope;
+
+        if (!request.timeout && this->options.timeout > 0)
+            request.timeout = this->options.timeout;
+
+        if (request.timeout)
+            scope.emplace(
+                std::stop_token{},
+                Budget{
+                    .time = std::chrono::duration_cast<
+                        std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double, std::milli>{
+                            *request.timeout
+                        }
+                    )
+                }
+            );
+
+        Variable const variable{request.variable};
+        std::string const &expression = request.expression;
+
+        if (request.op == "stats")
+            return response + ", \"result\": " + this->stats() + "}\n";
+
+        if (request.op == "evaluate") {
+            auto const program = this->compiled.get(expression, [&] {
+                try {
+                    return std::optional<Program>{*this->parse(expression)};
+                } catch (Cancelled const &) {
+                    throw;
+                } catch (BudgetExceeded const &) {
+                    throw;
+                } catch (std::runtime_error const &) {
+                    return std::optional<Program>{};
+                }
+            });
+
+            response += ", \"result\": ";
+
+            if (*program) {
+                number(response, mlp::evaluate(**program, request.values));
+            } else {
+                std::map<Variable, Token> values;
+
+                for (auto const &[name, value] : request.values)
+                    values[name] = value;
+
+                Token const result =
+                    mlp::evaluate(*this->parse(expression), values);
+
+                if (std::holds_alternative<Constant>(result))
+                    number(response, std::get<Constant>(result));
+                else
+                    quote(response, to_string(result));
+            }
+
+            return response + "}\n";
+        }
+
+        Token result;
+
+        if (request.op == "parse")
+            result = *this->parse(expression);
+
+        else if (request.op == "simplify")
+            result = *this->simplified.get(expression, [&] {
+                return mlp::simplified(*this->parse(expression));
+            });
+
+        else if (request.op == "derivative")
+            result = mlp::derivative(
+                *this->parse(expression), variable, request.order
+            );
+
+        else if (request.op == "integral")
+            result = mlp::integral(*this->parse(expression), variable);
+
+        else
+            throw std::runtime_error{"Unknown operation!"};
+
+        response += ", \"result\": ";
+        quote(response, to_string(result));
+    } catch (std::exception const &error) {
+        response.resize(7);
+        response += request.id;
+        response += ", \"error\": ";
+        quote(response, error.what());
+    }
+
+    return response + "}\n";
+}
+
+std::string mlp::Server::State::stats() {
+    std::string result{"{\"queue\": "};
+    result += std::to_string(this->queue.size());
+
+    auto const cache = [&result](std::string_view const name, auto &cache) {
+        result += ", \"";
+        result += name;
+        result += "\": {\"size\": " + std::to_string(cache.size()) +
+                  ", \"hits\": " + std::to_string(cache.hits.load()) +
+                  ", \"misses\": " + std::to_string(cache.misses.load()) +
+                  '}';
+    };
+
+    cache("parse", this->parsed);
+    cache("simplify", this->simplified);
+    cache("compile", this->compiled);
+
+    result += ", \"counters\": {";
+
+    Counters const snapshot = counters::snapshot();
+
+    for (std::size_t i = 0; i < snapshot.size(); ++i) {
+        if (i)
+            result += ", ";
+
+        quote(result, counters::name(static_cast<Counter>(i)));
+        result += ": " + std::to_string(snapshot[i]);
+    }
+
+    return result + "}}";
+}
+
+void mlp::Server::State::read(std::shared_ptr<Connection> const &connection) {
+    std::string buffer;
+    char chunk[4096];
+
+    while (this->running.load(std::memory_order_relaxed)) {
+        ssize_t const size =
+            ::recv(connection->descriptor(), chunk, sizeof chunk, 0);
+
+        if (size <= 0)
+            return;
+
+        buffer.append(chunk, static_cast<std::size_t>(size));
+
+        std::size_t begin = 0;
+
+        for (std::size_t end; (end = buffer.find('\n', begin)) !=
+                              std::string::npos;
+             begin = end + 1) {
+            if (end == begin)
+                continue;
+
+            if (end - begin > this->options.line) {
+                connection->send(k_too_long);
+
+                return;
+            }
+
+            if (!this->queue.push(
+                    {connection, buffer.substr(begin, end - begin)}
+                ))
+                return;
+        }
+
+        buffer.erase(0, begin);
+
+        // The rest of the buffer is an unfinished line.
+        if (buffer.size() > this->options.line) {
+            connection->send(k_too_long);
+
+            return;
+        }
+    }
+}
+
+void mlp::Server::State::work() {
+    while (auto job = this->queue.pop())
+        job->connection->send(this->handle(job->line));
+}
+
+mlp::Server::Server(
+    std::filesystem::path const &path, ServerOptions const &options
+)
+    : state(std::make_unique<State>(path, options)) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (path.native().size() >= sizeof address.sun_path)
+        throw std::runtime_error{"Socket path too long!"};
+
+    path.native().copy(address.sun_path, path.native().size());
+
+    counters::enable();
+
+    this->state->listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if (this->state->listener < 0)
+        throw std::runtime_error{"Cannot create socket!"};
+
+    ::unlink(path.c_str());
+
+    if (::bind(
+            this->state->listener, reinterpret_cast<sockaddr *>(&address),
+            sizeof address
+        ) < 0 ||
+        ::listen(this->state->listener, SOMAXCONN) < 0) {
+        ::close(this->state->listener);
+
+        throw std::runtime_error{"Cannot listen on socket!"};
+    }
+
+    for (std::size_t i = 0; i < std::max<std::size_t>(options.workers, 1); ++i)
+        this->state->workers.emplace_back([this] { this->state->work(); });
+}
+
+mlp::Server::~Server() {
+    this->stop();
+
+    this->state->workers.clear();
+
+    for (auto &[connection, reader] : this->state->readers)
+        if (auto const open = connection.lock())
+            ::shutdown(open->descriptor(), SHUT_RDWR);
+
+    this->state->readers.clear();
+
+    ::close(this->state->listener);
+    ::unlink(this->state->path.c_str());
+}
+
+void mlp::Server::serve() {
+    while (this->state->running.load(std::memory_order_relaxed)) {
+        int const socket =
+            ::accept4(this->state->listener, nullptr, nullptr, SOCK_CLOEXEC);
+
+        if (socket < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+
+            break;
+        }
+
+        auto connection =
+            std::make_shared<Connection>(socket, this->state->options.write);
+
+        std::lock_guard const lock{this->state->mutex};
+
+        std::erase_if(this->state->readers, [](auto const &reader) {
+            return reader.first.expired();
+        });
+
+        if (this->state->readers.size() >=
+            std::max<std::size_t>(this->state->options.connections, 1)) {
+            connection->send(k_too_many);
+
+            continue;
+        }
+
+        this->state->readers.emplace_back(
+            connection,
+            std::jthread{[state = this->state.get(), connection] {
+                state->read(connection);
+            }}
+        );
+    }
+}
+
+void mlp::Server::stop() {
+    if (!this->state->running.exchange(false))
+        return;
+
+    ::shutdown(this->state->listener, SHUT_RDWR);
+    this->state->queue.close();
+}
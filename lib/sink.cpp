@@ -0,0 +1,87 @@
+#include "../include/sink.h"
+
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+#include "../include/variable.h"
+
+#include <charconv>
+#include <iterator>
+
+namespace {
+constexpr std::size_t k_flush_size = 1 << 16;
+constexpr std::size_t k_number_size = 512;
+} // namespace
+
+mlp::Sink::Sink(std::ostream &stream) : stream(&stream) {}
+
+mlp::Sink::~Sink() { this->flush(); }
+
+mlp::Sink &mlp::Sink::operator<<(char const character) {
+    this->buffer.push_back(character);
+
+    return *this;
+}
+
+mlp::Sink &mlp::Sink::operator<<(std::string_view const string) {
+    this->buffer.append(string);
+
+    if (this->stream && this->buffer.size() >= k_flush_size)
+        this->flush();
+
+    return *this;
+}
+
+mlp::Sink &mlp::Sink::operator<<(Constant const value) {
+    char number[k_number_size];
+
+    auto const result = std::to_chars(
+        std::begin(number), std::end(number), value,
+        std::chars_format::general, 6
+    );
+
+    return *this << std::string_view{number, result.ptr};
+}
+
+mlp::Sink &mlp::Sink::operator<<(Sign const sign) {
+    return *this << (sign == Sign::pos ? '+' : '-');
+}
+
+mlp::Sink &mlp::Sink::operator<<(Token const &token) {
+    std::visit(
+        [this]<typename T>(T const &var) {
+            if constexpr (std::is_same_v<T, Constant>)
+                this->fixed(var);
+
+            else
+                var.write(*this);
+        },
+        token
+    );
+
+    return *this;
+}
+
+mlp::Sink &mlp::Sink::fixed(Constant const value) {
+    char number[k_number_size];
+
+    auto const result = std::to_chars(
+        std::begin(number), std::end(number), value,
+        std::chars_format::fixed, 6
+    );
+
+    return *this << std::string_view{number, result.ptr};
+}
+
+void mlp::Sink::flush() {
+    if (!this->stream)
+        return;
+
+    this->stream->write(
+        this->buffer.data(), static_cast<std::streamsize>(this->buffer.size())
+    );
+    this->buffer.clear();
+}
+
+std::string mlp::Sink::str() && { return std::move(this->buffer); }
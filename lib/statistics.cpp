@@ -0,0 +1,209 @@
+#include "../include/statistics.h"
+
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+#include "../include/variable.h"
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+struct Shape final {
+    std::size_t hash;
+    std::size_t heap_bytes;
+    // Equal for two subtrees exactly when they are structurally equal.
+    std::size_t id{0};
+};
+
+std::size_t combine(std::size_t const seed, std::size_t const value) {
+    return std::rotl(seed, 5) ^ (value + 0x9e3779b97f4a7c15 + (seed << 6));
+}
+
+std::size_t string_bytes(std::string const &string) {
+    auto const *data = string.data();
+    auto const *object = reinterpret_cast<char const *>(&string);
+
+    if (data >= object && data < object + sizeof(string))
+        return 0;
+
+    return string.capacity() + 1;
+}
+} // namespace
+
+namespace mlp {
+class Statistics::Collector final {
+    // A distinct subtree: its root and the ids of its children, so that
+    // telling two subtrees apart only compares the roots' own fields.
+    struct Node final {
+        Token const *token;
+        std::vector<std::size_t> children;
+        std::size_t id;
+    };
+
+    Statistics &statistics;
+    std::unordered_map<std::size_t, std::vector<Node>> seen;
+
+    static bool same(Token const &lhs, Token const &rhs);
+
+  public:
+    explicit Collector(Statistics &statistics) : statistics(statistics) {}
+
+    Shape visit(Token const &token, std::size_t depth);
+};
+
+// Whether two nodes whose children are equal are equal themselves.
+// Coefficients compare by their bits, as they are hashed.
+bool Statistics::Collector::same(Token const &lhs, Token const &rhs) {
+    if (lhs.index() != rhs.index())
+        return false;
+
+    auto const bits = [](Constant const value) {
+        return std::bit_cast<std::uint64_t>(value);
+    };
+
+    return std::visit(
+        [&rhs, &bits]<typename T>(T const &var) -> bool {
+            T const &other = std::get<T>(rhs);
+
+            if constexpr (std::is_same_v<T, Constant>)
+                return bits(var) == bits(other);
+            else if constexpr (std::is_same_v<T, Variable>)
+                return var.var == other.var &&
+                       bits(var.coefficient) == bits(other.coefficient);
+            else if constexpr (std::is_same_v<T, Function>)
+                return var.function == other.function;
+            else if constexpr (std::is_same_v<T, Term> ||
+                               std::is_same_v<T, Terms>)
+                return bits(var.coefficient) == bits(other.coefficient);
+            else
+                return std::ranges::equal(
+                    var.tokens, other.tokens, {},
+                    &std::pair<Sign, Token>::first,
+                    &std::pair<Sign, Token>::first
+                );
+        },
+        lhs
+    );
+}
+
+Shape Statistics::Collector::visit(
+    Token const &token, std::size_t const depth
+) {
+    ++this->statistics.nodes[token.index()];
+    this->statistics.depth = std::max(this->statistics.depth, depth);
+
+    std::vector<std::size_t> children;
+
+    Shape shape = std::visit(
+        [this, depth, &children]<typename T>(T const &var) -> Shape {
+            this->statistics.variant_overhead += sizeof(Token) - sizeof(T);
+
+            std::size_t hash = combine(0, std::variant_npos);
+
+            if constexpr (std::is_same_v<T, Constant>) {
+                return {combine(0, std::bit_cast<std::uint64_t>(var)), 0};
+            } else if constexpr (std::is_same_v<T, Variable>) {
+                hash = combine(var.var, std::bit_cast<std::uint64_t>(
+                                            var.coefficient
+                                        ));
+
+                return {combine(1, hash), 0};
+            } else if constexpr (std::is_same_v<T, Function>) {
+                std::size_t bytes = string_bytes(var.function) +
+                                    var.parameters.capacity() * sizeof(Token);
+                hash = std::hash<std::string>{}(var.function);
+
+                for (Token const &parameter : var.parameters) {
+                    auto const child = this->visit(parameter, depth + 1);
+                    children.push_back(child.id);
+                    hash = combine(hash, child.hash);
+                    bytes += child.heap_bytes;
+                }
+
+                return {combine(2, hash), bytes};
+            } else if constexpr (std::is_same_v<T, Term>) {
+                auto const base = this->visit(*var.base, depth + 1);
+                auto const power = this->visit(*var.power, depth + 1);
+                children = {base.id, power.id};
+
+                hash = combine(
+                    std::bit_cast<std::uint64_t>(var.coefficient), base.hash
+                );
+
+                return {
+                    combine(3, combine(hash, power.hash)),
+                    2 * sizeof(Token) + base.heap_bytes + power.heap_bytes
+                };
+            } else if constexpr (std::is_same_v<T, Terms>) {
+                std::size_t bytes = var.terms.capacity() * sizeof(Token);
+                hash = std::bit_cast<std::uint64_t>(var.coefficient);
+
+                for (Token const &term : var.terms) {
+                    auto const child = this->visit(term, depth + 1);
+                    children.push_back(child.id);
+                    hash = combine(hash, child.hash);
+                    bytes += child.heap_bytes;
+                }
+
+                return {combine(4, hash), bytes};
+            } else {
+                std::size_t bytes = var.tokens.capacity() *
+                                    sizeof(std::pair<Sign, Token>);
+
+                for (auto const &[sign, term] : var.tokens) {
+                    auto const child = this->visit(term, depth + 1);
+                    children.push_back(child.id);
+                    hash = combine(hash, static_cast<std::size_t>(sign));
+                    hash = combine(hash, child.hash);
+                    bytes += child.heap_bytes;
+                }
+
+                return {combine(5, hash), bytes};
+            }
+        },
+        token
+    );
+
+    auto &candidates = this->seen[shape.hash];
+    auto const match = std::ranges::find_if(
+        candidates,
+        [&token, &children](Node const &node) {
+            return node.children == children && same(*node.token, token);
+        }
+    );
+
+    if (match != candidates.end()) {
+        shape.id = match->id;
+        ++this->statistics.shared_subtrees;
+        this->statistics.shared_bytes += sizeof(Token) + shape.heap_bytes;
+    } else {
+        shape.id = this->statistics.unique_subtrees++;
+        candidates.push_back({&token, std::move(children), shape.id});
+    }
+
+    return shape;
+}
+} // namespace mlp
+
+std::size_t mlp::Statistics::node_count() const {
+    return std::accumulate(this->nodes.begin(), this->nodes.end(), 0uz);
+}
+
+std::size_t mlp::Statistics::total_bytes() const {
+    return this->inline_bytes + this->heap_bytes;
+}
+
+mlp::Statistics mlp::statistics(Token const &token) {
+    Statistics result;
+    Statistics::Collector collector{result};
+
+    result.inline_bytes = sizeof(Token);
+    result.heap_bytes = collector.visit(token, 1).heap_bytes;
+
+    return result;
+}
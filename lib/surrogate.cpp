@@ -0,0 +1,369 @@
+#include "../include/surrogate.h"
+
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/program.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <string>
+#include <utility>
+
+namespace {
+constexpr std::uint32_t k_initial = 16;
+// Points of one piece evaluated side by side.
+constexpr std::size_t k_lanes = 16;
+
+// Evaluates the compiled function at a batch of points, with every other
+// input fixed.
+class Probe final {
+    mlp::Program program;
+    std::size_t slot{std::string::npos};
+    std::vector<mlp::Constant> fixed;
+    std::vector<mlp::Column> columns;
+    std::vector<mlp::Constant> scratch;
+
+  public:
+    Probe(
+        mlp::Token const &token, mlp::Variable const variable,
+        std::map<mlp::Variable, mlp::Constant> const &values
+    )
+        : program(token) {
+        for (char const input : this->program.variables()) {
+            if (mlp::Variable{input} == variable) {
+                this->slot = this->fixed.size();
+                this->fixed.push_back(0);
+
+                continue;
+            }
+
+            auto const value = values.find(mlp::Variable{input});
+
+            if (value == values.end())
+                throw std::runtime_error{"Missing value for variable!"};
+
+            this->fixed.push_back(value->second);
+        }
+
+        for (std::size_t i = 0; i < this->fixed.size(); ++i)
+            this->columns.push_back({&this->fixed[i], 0});
+    }
+
+    void operator()(
+        std::span<mlp::Constant const> const x,
+        std::span<mlp::Constant> const results
+    ) {
+        if (this->slot != std::string::npos)
+            this->columns[this->slot] = {x.data()};
+
+        mlp::evaluate(
+            this->program, this->columns, x.size(), results, this->scratch
+        );
+    }
+};
+
+// The n + 1 Chebyshev extrema cos(pi k / n) mapped onto [lower, upper].
+std::vector<mlp::Constant> extrema(
+    mlp::Constant const lower, mlp::Constant const upper, std::uint32_t const n
+) {
+    std::vector<mlp::Constant> x(n + 1);
+
+    for (std::uint32_t k = 0; k <= n; ++k)
+        x[k] = (lower + upper) / 2 +
+               (upper - lower) / 2 * std::cos(std::numbers::pi * k / n);
+
+    return x;
+}
+
+// The coefficients of the degree n interpolant through values at the
+// extrema, by the discrete cosine transform.
+std::vector<mlp::Constant>
+transform(std::span<mlp::Constant const> const values, std::uint32_t const n) {
+    std::vector<mlp::Constant> cosines(2 * n);
+
+    for (std::uint32_t m = 0; m < 2 * n; ++m)
+        cosines[m] = std::cos(std::numbers::pi * m / n);
+
+    std::vector<mlp::Constant> coefficients(n + 1);
+
+    for (std::uint32_t j = 0; j <= n; ++j) {
+        mlp::Constant sum =
+            (values[0] + (j % 2 == 0 ? values[n] : -values[n])) / 2;
+
+        for (std::uint32_t k = 1; k < n; ++k)
+            sum += values[k] * cosines[j * k % (2 * n)];
+
+        coefficients[j] = sum * 2 / n;
+    }
+
+    coefficients[0] /= 2;
+    coefficients[n] /= 2;
+
+    return coefficients;
+}
+
+mlp::Constant clenshaw(
+    std::span<mlp::Constant const> const coefficients, mlp::Constant const t
+) {
+    mlp::Constant first = 0;
+    mlp::Constant second = 0;
+
+    for (std::size_t j = coefficients.size(); j-- > 1;)
+        second = std::exchange(first, 2 * t * first - second + coefficients[j]);
+
+    return t * first - second + coefficients[0];
+}
+} // namespace
+
+mlp::Surrogate::Surrogate(
+    Token const &token, Variable const variable, Constant const lower,
+    Constant const upper, std::map<Variable, Constant> const &values,
+    SurrogateOptions const &options
+) {
+    if (!(lower < upper))
+        throw std::runtime_error{"Empty domain!"};
+
+    if (options.degree < k_initial || options.pieces == 0)
+        throw std::runtime_error{"Invalid surrogate options!"};
+
+    Probe probe{token, variable, values};
+
+    // The scale the tolerance is relative to, from the densest grid a
+    // single piece may use.
+    Constant scale = 0;
+
+    {
+        std::vector<Constant> const x = extrema(lower, upper, options.degree);
+        std::vector<Constant> y(x.size());
+        probe(x, y);
+
+        for (Constant const value : y)
+            if (std::isfinite(value))
+                scale = std::max(scale, std::fabs(value));
+    }
+
+    Constant const target = options.tolerance * (scale > 0 ? scale : 1);
+    std::uint32_t splits = options.pieces - 1;
+
+    this->breaks.push_back(lower);
+    this->offsets.push_back(0);
+
+    auto const build = [&](auto const &self, Constant const a,
+                           Constant const b) -> void {
+        std::vector<Constant> fit;
+        Constant estimate = std::numeric_limits<Constant>::infinity();
+        bool finite = true;
+        bool converged = false;
+
+        for (std::uint32_t n = k_initial; n <= options.degree; n *= 2) {
+            std::vector<Constant> const x = extrema(a, b, n);
+            std::vector<Constant> y(x.size());
+            probe(x, y);
+
+            if (!std::ranges::all_of(y, [](Constant const value) {
+                    return std::isfinite(value);
+                })) {
+                finite = false;
+
+                break;
+            }
+
+            fit = transform(y, n);
+
+            // The last quarter of the coefficients stands in for the part
+            // of the series beyond degree n.
+            Constant tail = 0;
+
+            for (std::uint32_t j = 3 * n / 4 + 1; j <= n; ++j)
+                tail += std::fabs(fit[j]);
+
+            estimate = tail;
+
+            if (tail <= target / 2) {
+                Constant dropped = 0;
+
+                while (fit.size() > 1 &&
+                       dropped + std::fabs(fit.back()) <= target / 2) {
+                    dropped += std::fabs(fit.back());
+                    fit.pop_back();
+                }
+
+                estimate = tail + dropped;
+                converged = true;
+
+                break;
+            }
+        }
+
+        if (finite) {
+            // Check halfway between the extrema of the last fit.
+            std::uint32_t const n = static_cast<std::uint32_t>(
+                std::max<std::size_t>(fit.size(), k_initial)
+            );
+            std::vector<Constant> x(n);
+            std::vector<Constant> y(n);
+
+            for (std::uint32_t k = 0; k < n; ++k)
+                x[k] = (a + b) / 2 + (b - a) / 2 *
+                                         std::cos(
+                                             std::numbers::pi * (2 * k + 1) /
+                                             (2 * n)
+                                         );
+
+            probe(x, y);
+
+            for (std::uint32_t k = 0; k < n; ++k)
+                estimate = std::max(
+                    estimate,
+                    std::fabs(
+                        y[k] - clenshaw(fit, (2 * x[k] - a - b) / (b - a))
+                    )
+                );
+
+            if (!std::isfinite(estimate))
+                finite = false;
+            else if (estimate > target)
+                converged = false;
+        }
+
+        if (!converged && splits > 0) {
+            --splits;
+            self(self, a, (a + b) / 2);
+            self(self, (a + b) / 2, b);
+
+            return;
+        }
+
+        if (!finite)
+            throw std::runtime_error{"Function is not finite on the domain!"};
+
+        this->coefficients.insert(
+            this->coefficients.end(), fit.begin(), fit.end()
+        );
+        this->breaks.push_back(b);
+        this->offsets.push_back(this->coefficients.size());
+        this->bound = std::max(this->bound, estimate);
+    };
+
+    build(build, lower, upper);
+}
+
+mlp::Constant mlp::Surrogate::error() const { return this->bound; }
+
+std::size_t mlp::Surrogate::pieces() const { return this->breaks.size() - 1; }
+
+std::size_t mlp::Surrogate::degree() const {
+    std::size_t degree = 0;
+
+    for (std::size_t i = 0; i + 1 < this->offsets.size(); ++i)
+        degree = std::max(degree, this->offsets[i + 1] - this->offsets[i] - 1);
+
+    return degree;
+}
+
+std::size_t mlp::Surrogate::locate(Constant const x) const {
+    if (!(x >= this->breaks.front() && x <= this->breaks.back()))
+        return this->breaks.size();
+
+    return std::upper_bound(
+               this->breaks.begin() + 1, this->breaks.end() - 1, x
+           ) -
+           (this->breaks.begin() + 1);
+}
+
+mlp::Constant mlp::Surrogate::evaluate(Constant const x) const {
+    std::size_t const piece = this->locate(x);
+
+    if (piece == this->breaks.size())
+        return std::numeric_limits<Constant>::quiet_NaN();
+
+    Constant const a = this->breaks[piece];
+    Constant const b = this->breaks[piece + 1];
+
+    return clenshaw(
+        std::span{this->coefficients}.subspan(
+            this->offsets[piece],
+            this->offsets[piece + 1] - this->offsets[piece]
+        ),
+        (2 * x - a - b) / (b - a)
+    );
+}
+
+void mlp::Surrogate::evaluate(
+    std::span<Constant const> const x, std::span<Constant> const results
+) const {
+    if (results.size() != x.size())
+        throw std::runtime_error{"Mismatched row counts!"};
+
+    // Points are grouped by piece with a counting sort, and each piece runs
+    // its recurrence over blocks of its points one coefficient at a time,
+    // in fixed-length loops the compiler vectorises. Pieces with less than a
+    // block of points take the scalar path instead.
+    std::size_t const pieces = this->pieces();
+    std::vector<std::uint32_t> which(x.size());
+    std::vector<std::size_t> starts(pieces + 2, 0);
+
+    // Points outside the domain get the index one past the last piece.
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        which[i] = static_cast<std::uint32_t>(
+            std::min(this->locate(x[i]), pieces)
+        );
+        ++starts[which[i] + 1];
+    }
+
+    for (std::size_t piece = 0; piece <= pieces; ++piece)
+        starts[piece + 1] += starts[piece];
+
+    std::vector<std::size_t> order(x.size());
+
+    {
+        std::vector<std::size_t> next(starts.begin(), starts.end() - 1);
+
+        for (std::size_t i = 0; i < x.size(); ++i)
+            order[next[which[i]]++] = i;
+    }
+
+    for (std::size_t piece = 0; piece < pieces; ++piece) {
+        std::size_t const end = starts[piece + 1];
+        Constant const a = this->breaks[piece];
+        Constant const b = this->breaks[piece + 1];
+        std::span const series = std::span{this->coefficients}.subspan(
+            this->offsets[piece],
+            this->offsets[piece + 1] - this->offsets[piece]
+        );
+
+        std::size_t k = starts[piece];
+
+        for (; k + k_lanes <= end; k += k_lanes) {
+            std::array<Constant, k_lanes> t;
+            std::array<Constant, k_lanes> first{};
+            std::array<Constant, k_lanes> second{};
+
+            for (std::size_t lane = 0; lane < k_lanes; ++lane)
+                t[lane] = (2 * x[order[k + lane]] - a - b) / (b - a);
+
+            for (std::size_t j = series.size(); j-- > 1;)
+                for (std::size_t lane = 0; lane < k_lanes; ++lane)
+                    second[lane] = std::exchange(
+                        first[lane],
+                        2 * t[lane] * first[lane] - second[lane] + series[j]
+                    );
+
+            for (std::size_t lane = 0; lane < k_lanes; ++lane)
+                results[order[k + lane]] =
+                    t[lane] * first[lane] - second[lane] + series[0];
+        }
+
+        for (; k < end; ++k)
+            results[order[k]] =
+                clenshaw(series, (2 * x[order[k]] - a - b) / (b - a));
+    }
+
+    for (std::size_t k = starts[pieces]; k < x.size(); ++k)
+        results[order[k]] = std::numeric_limits<Constant>::quiet_NaN();
+}
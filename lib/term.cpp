@@ -1,26 +1,40 @@
 #include "../include/term.h"
 
+#include "../include/cancellation.h"
+#include "../include/counters.h"
 #include "../include/expression.h"
 #include "../include/function.h"
+#include "../include/sink.h"
 #include "../include/terms.h"
 #include "../include/variable.h"
 
 #include <map>
-#include <sstream>
 #include <utility>
 
 mlp::Term::Term(Constant const coefficient, Token base, Token power)
     : coefficient(coefficient), base(new Token(std::move(base))),
-      power(new Token(std::move(power))) {}
+      power(new Token(std::move(power))) {
+    count(Counter::node_allocations, 2);
+    cancellation::charge(2, 2 * sizeof(Token));
+}
 
 mlp::Term::Term(Token base, Token power)
-    : base(new Token(std::move(base))), power(new Token(std::move(power))) {}
+    : base(new Token(std::move(base))), power(new Token(std::move(power))) {
+    count(Counter::node_allocations, 2);
+    cancellation::charge(2, 2 * sizeof(Token));
+}
 
 mlp::Term::Term(Term const &term)
     : coefficient(term.coefficient), base(new Token(*term.base)),
-      power(new Token(*term.power)) {}
+      power(new Token(*term.power)) {
+    count(Counter::node_allocations, 2);
+    cancellation::charge(2, 2 * sizeof(Token));
+    count(Counter::term_copies);
+}
 
 mlp::Term &mlp::Term::operator=(Term const &term) {
+    count(Counter::term_copies);
+
     this->coefficient = term.coefficient;
     *this->base = *term.base;
     *this->power = *term.power;
@@ -29,38 +43,41 @@ mlp::Term &mlp::Term::operator=(Term const &term) {
 }
 
 mlp::Term::operator std::string() const {
-    std::stringstream result;
+    Sink sink;
+    this->write(sink);
 
+    return std::move(sink).str();
+}
+
+void mlp::Term::write(Sink &sink) const {
     if (this->coefficient != 1) {
         if (this->coefficient == -1)
-            result << "-";
+            sink << '-';
 
         else
-            result << this->coefficient;
+            sink << this->coefficient;
     }
 
-    result << '(';
+    sink << '(';
 
     if (std::holds_alternative<Constant>(*this->power)) {
         Constant const &power = std::get<Constant>(*this->power);
 
         if (power == 0.5)
-            result << "\u221A" << *this->base;
+            sink << "\u221A" << *this->base;
         else if (power == 1.0 / 3.0)
-            result << "\u221B" << *this->base;
+            sink << "\u221B" << *this->base;
         else if (power == 1.0 / 4.0)
-            result << "\u221C" << *this->base;
+            sink << "\u221C" << *this->base;
         else if (power != 1)
-            result << *this->base << '^' << *this->power;
+            sink << *this->base << '^' << *this->power;
         else
-            result << *this->base;
+            sink << *this->base;
     } else {
-        result << *this->base << '^' << *this->power;
+        sink << *this->base << '^' << *this->power;
     }
 
-    result << ')';
-
-    return result.str();
+    sink << ')';
 }
 
 mlp::Term mlp::Term::operator-() const {
@@ -1,17 +1,22 @@
 #include "../include/terms.h"
 
+#include "../include/cancellation.h"
+#include "../include/counters.h"
 #include "../include/expression.h"
 #include "../include/function.h"
+#include "../include/pool.h"
+#include "../include/sink.h"
 #include "../include/term.h"
 #include "../include/variable.h"
 
 #include <algorithm>
 #include <map>
-#include <sstream>
 
 mlp::Terms::Terms(Terms const &terms) { *this = terms; }
 
 mlp::Terms &mlp::Terms::operator=(Terms const &terms) {
+    count(Counter::terms_copies);
+
     this->coefficient = terms.coefficient;
     this->terms.clear();
 
@@ -22,28 +27,31 @@ mlp::Terms &mlp::Terms::operator=(Terms const &terms) {
 }
 
 mlp::Terms::operator std::string() const {
-    std::stringstream result;
+    Sink sink;
+    this->write(sink);
+
+    return std::move(sink).str();
+}
 
+void mlp::Terms::write(Sink &sink) const {
     if (this->coefficient != 1) {
         if (this->coefficient == -1)
-            result << "-";
+            sink << '-';
 
         else
-            result << this->coefficient;
+            sink << this->coefficient;
     }
 
-    result << '(';
+    sink << '(';
 
     for (std::size_t i = 0; i < this->terms.size(); ++i) {
-        result << to_string(this->terms[i]);
+        sink << this->terms[i];
 
         if (i != this->terms.size() - 1)
-            result << '*';
+            sink << '*';
     }
 
-    result << ')';
-
-    return result.str();
+    sink << ')';
 }
 
 mlp::Terms mlp::Terms::operator-() const {
@@ -62,7 +70,11 @@ mlp::Terms &mlp::Terms::operator*=(Variable variable) {
         variable.coefficient = 1;
     }
 
+    count(Counter::like_term_scans);
+
     for (Token &term : this->terms) {
+        count(Counter::like_term_steps);
+
         if (std::holds_alternative<Variable>(term)) {
             auto const &v = std::get<Variable>(term);
 
@@ -142,7 +154,11 @@ mlp::Terms &mlp::Terms::operator*=(Term term) {
 
     auto &power = std::get<Expression>(*term.power);
 
+    count(Counter::like_term_scans);
+
     for (Token &t : this->terms) {
+        count(Counter::like_term_steps);
+
         if (std::holds_alternative<Variable>(t)) {
             if (auto const &v = std::get<Variable>(t); v != variable)
                 continue;
@@ -204,6 +220,8 @@ mlp::Terms &mlp::Terms::operator*=(Expression expression) {
 }
 
 mlp::Terms &mlp::Terms::operator*=(Token token) {
+    cancellation::charge(1, sizeof(Token));
+
     return std::visit(
         [this](auto &&var) -> Terms & { return *this *= var; }, token
     );
@@ -312,7 +330,11 @@ mlp::Terms &mlp::Terms::operator/=(Term term) {
 
     auto &power = std::get<Expression>(*term.power);
 
+    count(Counter::like_term_scans);
+
     for (Token &t : this->terms) {
+        count(Counter::like_term_steps);
+
         if (std::holds_alternative<Variable>(t)) {
             auto &v = std::get<Variable>(t);
 
@@ -584,8 +606,19 @@ Token simplified(Terms const &token) {
     Terms terms{};
     terms.coefficient = token.coefficient;
 
-    for (Token const &token_ : token.terms)
-        terms *= simplified(token_);
+    if (!parallel_block(token.terms.size())) {
+        for (Token const &token_ : token.terms)
+            terms *= simplified(token_);
+    } else {
+        std::vector<Token> factors(token.terms.size());
+
+        parallel_for(factors.size(), [&factors, &token](std::size_t const i) {
+            factors[i] = simplified(token.terms[i]);
+        });
+
+        for (Token &factor : factors)
+            terms *= std::move(factor);
+    }
 
     if (terms.terms.empty())
         return terms.coefficient;
@@ -617,9 +650,7 @@ Token derivative(
     if (token.coefficient == 0 || !is_dependent_on(token, variable))
         return 0.0;
 
-    Expression result{};
-
-    for (std::size_t i = 0; i < token.terms.size(); ++i) {
+    auto const product_rule = [&token, variable](std::size_t const i) {
         Terms term{};
 
         for (std::size_t j = 0; j < token.terms.size(); ++j) {
@@ -632,7 +663,28 @@ Token derivative(
             term *= mlp::derivative(token.terms[i], variable, 1);
         }
 
-        result += term;
+        return term;
+    };
+
+    Expression result{};
+
+    if (!parallel_block(token.terms.size())) {
+        for (std::size_t i = 0; i < token.terms.size(); ++i)
+            result += product_rule(i);
+    } else {
+        std::vector<Expression> partials(token.terms.size());
+
+        parallel_for(
+            partials.size(),
+            [&partials, &product_rule](std::size_t const i) {
+                partials[i] += product_rule(i);
+            }
+        );
+
+        result = parallel_reduce(
+            std::move(partials),
+            [](Expression &lhs, Expression &&rhs) { lhs += rhs; }
+        );
     }
 
     auto derivative = simplified(token.coefficient * result);
@@ -1,9 +1,14 @@
 #include "../include/token.h"
 
+#include "../include/cancellation.h"
+#include "../include/context.h"
+#include "../include/counters.h"
 #include "../include/expression.h"
 #include "../include/function.h"
+#include "../include/sink.h"
 #include "../include/term.h"
 #include "../include/terms.h"
+#include "../include/trace.h"
 #include "../include/variable.h"
 
 #include <algorithm>
@@ -27,6 +32,38 @@ std::map<char, char> const k_parenthesis_map{
     {'(', ')'}, {'[', ']'}, {'{', '}'}
 };
 
+std::vector<mlp::Token>
+get_parameters(std::string const &expression, std::size_t &i) {
+    std::vector<mlp::Token> parameters;
+
+    std::size_t count = 0;
+    std::size_t start = i + 1;
+
+    for (; i < expression.size(); ++i) {
+        char const character = expression[i];
+
+        if (k_parenthesis_map.contains(character))
+            ++count;
+
+        else if (std::ranges::contains(
+                     k_parenthesis_map | std::views::values, character
+                 ))
+            --count;
+
+        if (!count || (count == 1 && character == ',')) {
+            parameters.push_back(
+                mlp::tokenise(expression.substr(start, i - start))
+            );
+            start = i + 1;
+        }
+
+        if (!count)
+            return parameters;
+    }
+
+    throw std::invalid_argument("Expression is not valid!");
+}
+
 std::variant<Operation, std::optional<mlp::Token>>
 get_next_token(std::string const &expression, std::size_t &i) {
     if (i >= expression.size())
@@ -104,6 +141,10 @@ get_next_token(std::string const &expression, std::size_t &i) {
             func += expression[i++];
 
         if (mlp::Function::is_defined(func)) {
+            if (i < expression.size() &&
+                k_parenthesis_map.contains(expression[i]))
+                return mlp::Function(func, get_parameters(expression, i));
+
             auto token = get_next_token(expression, i);
 
             if (std::holds_alternative<Operation>(token))
@@ -147,12 +188,27 @@ bool mlp::is_linear_of(Token const &token, Variable variable) {
 
 mlp::Token
 mlp::evaluate(Token const &token, std::map<Variable, Token> const &values) {
+    trace::Span const span{"evaluate", token};
+    Context::Pin const pin;
+
     return std::visit(
         [&values](auto &&var) -> Token { return evaluate(var, values); }, token
     );
 }
 
 mlp::Token mlp::simplified(Token const &token) {
+    count(
+        static_cast<Counter>(
+            static_cast<std::uint32_t>(Counter::simplified_constant) +
+            token.index()
+        )
+    );
+
+    cancellation::checkpoint();
+
+    trace::Span const span{"simplified", token};
+    Context::Pin const pin;
+
     return std::visit(
         [](auto &&var) -> Token { return simplified(var); }, token
     );
@@ -168,6 +224,11 @@ mlp::Token mlp::derivative(
 mlp::Token mlp::derivative(
     Token const &token, Variable variable, std::uint32_t const order
 ) {
+    cancellation::checkpoint();
+
+    trace::Span const span{"derivative", token};
+    Context::Pin const pin;
+
     return std::visit(
         [&variable, &order](auto &&var) -> Token {
             return derivative(var, variable, order);
@@ -177,6 +238,11 @@ mlp::Token mlp::derivative(
 }
 
 mlp::Token mlp::integral(Token const &token, Variable variable) {
+    cancellation::checkpoint();
+
+    trace::Span const span{"integral", token};
+    Context::Pin const pin;
+
     return std::visit(
         [&variable](auto &&var) -> Token { return integral(var, variable); },
         token
@@ -195,6 +261,8 @@ mlp::Token mlp::integral(
 }
 
 mlp::Token mlp::tokenise(std::string expression) {
+    trace::Span const span{"tokenise"};
+
     Expression result{};
 
     auto e = std::ranges::remove(expression, ' ');
@@ -471,16 +539,10 @@ std::istream &operator>>(std::istream &input, Token &output) {
 } // namespace mlp
 
 std::string to_string(mlp::Token const &token) {
-    return std::visit(
-        []<typename T>(T &&var) -> std::string {
-            if constexpr (std::is_same_v<std::decay_t<T>, mlp::Constant>)
-                return std::to_string(var);
+    mlp::Sink sink;
+    sink << token;
 
-            else
-                return static_cast<std::string>(var);
-        },
-        token
-    );
+    return std::move(sink).str();
 }
 
 std::string to_string(mlp::Sign const sign) {
@@ -488,7 +550,7 @@ std::string to_string(mlp::Sign const sign) {
 }
 
 std::ostream &mlp::operator<<(std::ostream &os, Token const &token) {
-    os << to_string(token);
+    Sink{os} << token;
 
     return os;
 }
\ No newline at end of file
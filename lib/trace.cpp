@@ -0,0 +1,138 @@
+#include "../include/trace.h"
+
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+#include "../include/variable.h"
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr std::array<std::string_view, 6> k_types{
+    "Constant", "Variable", "Function", "Term", "Terms", "Expression"
+};
+
+struct Writer final {
+    std::mutex mutex;
+    std::ofstream output;
+    Clock::time_point epoch;
+    bool first{true};
+    std::uint32_t threads{0};
+
+    ~Writer() {
+        if (this->output.is_open())
+            this->output << "\n]}\n";
+    }
+};
+
+Writer &writer() {
+    static Writer writer;
+
+    return writer;
+}
+
+thread_local std::uint32_t t_depth = 0;
+thread_local std::uint32_t t_thread = 0;
+
+std::int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               Clock::now() - writer().epoch
+    )
+        .count();
+}
+} // namespace
+
+void mlp::trace::start(std::string const &path) {
+    Writer &writer = ::writer();
+    std::lock_guard const lock{writer.mutex};
+
+    if (writer.output.is_open())
+        throw std::runtime_error{"Trace already started!"};
+
+    writer.output.open(path);
+
+    if (!writer.output)
+        throw std::runtime_error{"Cannot open trace file!"};
+
+    writer.output << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    writer.output << std::fixed << std::setprecision(3);
+    writer.epoch = Clock::now();
+    writer.first = true;
+
+    g_enabled.store(true, std::memory_order_release);
+}
+
+void mlp::trace::stop() {
+    Writer &writer = ::writer();
+    std::lock_guard const lock{writer.mutex};
+
+    g_enabled.store(false, std::memory_order_release);
+
+    if (!writer.output.is_open())
+        return;
+
+    writer.output << "\n]}\n";
+    writer.output.close();
+}
+
+bool mlp::trace::enabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+mlp::trace::Span::Span(std::string_view const name, Token const &token)
+    : name(name) {
+    if (g_enabled.load(std::memory_order_relaxed))
+        this->open("type", k_types[token.index()]);
+}
+
+mlp::trace::Span::Span(
+    std::string_view const name, std::string_view const detail
+)
+    : name(name) {
+    if (g_enabled.load(std::memory_order_relaxed))
+        this->open("detail", detail);
+}
+
+void mlp::trace::Span::open(
+    std::string_view const key, std::string_view const detail
+) {
+    this->key = key;
+    this->detail = detail;
+    this->depth = t_depth++;
+    this->begin = now();
+}
+
+void mlp::trace::Span::close() const {
+    std::int64_t const end = now();
+
+    --t_depth;
+
+    Writer &writer = ::writer();
+    std::lock_guard const lock{writer.mutex};
+
+    if (!writer.output.is_open())
+        return;
+
+    if (!t_thread)
+        t_thread = ++writer.threads;
+
+    writer.output << (writer.first ? "\n" : ",\n") << "{\"name\": \""
+                  << this->name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                  << t_thread << ", \"ts\": " << this->begin / 1e3
+                  << ", \"dur\": " << (end - this->begin) / 1e3
+                  << ", \"args\": {\"depth\": " << this->depth;
+
+    if (!this->detail.empty())
+        writer.output << ", \"" << this->key << "\": \"" << this->detail
+                      << '"';
+
+    writer.output << "}}";
+    writer.first = false;
+}
@@ -2,11 +2,12 @@
 
 #include "../include/expression.h"
 #include "../include/function.h"
+#include "../include/sink.h"
 #include "../include/term.h"
 #include "../include/terms.h"
 
+#include <istream>
 #include <map>
-#include <sstream>
 
 mlp::Variable::Variable(Constant const coefficient, char const var)
     : var(var), coefficient(coefficient) {}
@@ -14,24 +15,27 @@ mlp::Variable::Variable(Constant const coefficient, char const var)
 mlp::Variable::Variable(char const var) : var(var) {}
 
 mlp::Variable::operator std::string() const {
-    std::stringstream stream;
+    Sink sink;
+    this->write(sink);
 
+    return std::move(sink).str();
+}
+
+void mlp::Variable::write(Sink &sink) const {
     if (this->coefficient == 0) {
-        stream << 0;
+        sink << '0';
 
-        return stream.str();
+        return;
     }
 
     if (this->coefficient != 1) {
         if (this->coefficient == -1)
-            stream << "-";
+            sink << '-';
         else
-            stream << this->coefficient;
+            sink << this->coefficient;
     }
 
-    stream << this->var;
-
-    return stream.str();
+    sink << this->var;
 }
 
 mlp::Variable mlp::Variable::operator-() const {
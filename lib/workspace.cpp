@@ -0,0 +1,285 @@
+#include "../include/workspace.h"
+
+#include "../include/cancellation.h"
+#include "../include/expression.h"
+#include "../include/function.h"
+#include "../include/term.h"
+#include "../include/terms.h"
+#include "../include/variable.h"
+
+#include <algorithm>
+#include <cctype>
+#include <tuple>
+
+struct mlp::Workspace::Binding final {
+    std::vector<Variable> parameters;
+    // tokenise() inlines the bindings a body calls, so bodies given as text
+    // are kept as text and parsed again whenever an upstream binding changes.
+    std::string source;
+    Token body;
+    Token value;
+    std::optional<Program> program;
+    std::set<std::string> dependencies;
+    std::set<std::string> dependents;
+};
+
+mlp::Workspace::Workspace() = default;
+
+mlp::Workspace::~Workspace() = default;
+
+void mlp::Workspace::collect(
+    Token const &token, std::set<std::string> &names
+) const {
+    std::visit(
+        [this, &names]<typename T>(T const &var) {
+            if constexpr (std::is_same_v<T, Function>) {
+                if (this->bindings.contains(var.function))
+                    names.insert(var.function);
+
+                for (Token const &parameter : var.parameters)
+                    this->collect(parameter, names);
+            } else if constexpr (std::is_same_v<T, Term>) {
+                this->collect(*var.base, names);
+                this->collect(*var.power, names);
+            } else if constexpr (std::is_same_v<T, Terms>) {
+                for (Token const &term : var.terms)
+                    this->collect(term, names);
+            } else if constexpr (std::is_same_v<T, Expression>) {
+                for (auto const &[sign, term] : var.tokens)
+                    this->collect(term, names);
+            }
+        },
+        token
+    );
+}
+
+void mlp::Workspace::collect(
+    std::string_view const source, std::set<std::string> &names
+) const {
+    for (std::size_t i = 0; i < source.size();) {
+        if (!isalpha(static_cast<unsigned char>(source[i]))) {
+            ++i;
+
+            continue;
+        }
+
+        std::size_t const start = i;
+
+        while (i < source.size() &&
+               isalpha(static_cast<unsigned char>(source[i])))
+            ++i;
+
+        if (std::string name{source.substr(start, i - start)};
+            this->bindings.contains(name))
+            names.insert(std::move(name));
+    }
+}
+
+std::vector<std::string>
+mlp::Workspace::downstream(std::string const &name) const {
+    // Depth-first post-order over the dependents, reversed, puts every
+    // binding after all of the affected bindings it calls.
+    std::vector<std::string> order;
+    std::set<std::string> visited;
+
+    auto const visit = [this, &order, &visited](
+                           auto const &self, std::string const &current
+                       ) -> void {
+        if (!visited.insert(current).second)
+            return;
+
+        for (std::string const &dependent :
+             this->bindings.at(current)->dependents)
+            self(self, dependent);
+
+        order.push_back(current);
+    };
+
+    visit(visit, name);
+    std::ranges::reverse(order);
+
+    return order;
+}
+
+void mlp::Workspace::link(
+    std::string const &name, std::set<std::string> dependencies
+) {
+    Binding &binding = *this->bindings.at(name);
+
+    for (std::string const &dependency : binding.dependencies)
+        this->bindings.at(dependency)->dependents.erase(name);
+
+    for (std::string const &dependency : dependencies)
+        this->bindings.at(dependency)->dependents.insert(name);
+
+    binding.dependencies = std::move(dependencies);
+}
+
+void mlp::Workspace::recompute(std::string const &name) {
+    Binding &binding = *this->bindings.at(name);
+
+    {
+        Context::Scope const scope{this->scope};
+
+        if (!binding.source.empty())
+            binding.body = mlp::tokenise(binding.source);
+
+        binding.value = simplified(binding.body);
+    }
+
+    try {
+        binding.program.emplace(binding.value);
+    } catch (Cancelled const &) {
+        throw;
+    } catch (BudgetExceeded const &) {
+        throw;
+    } catch (std::runtime_error const &) {
+        binding.program.reset();
+    }
+
+    this->scope.define(name, binding.parameters, binding.value);
+}
+
+std::vector<std::string> mlp::Workspace::update(
+    std::string const &name, Binding binding,
+    std::set<std::string> dependencies
+) {
+    if (builtin_id(name))
+        throw std::runtime_error{"Cannot redefine built-in functions!"};
+
+    bool const existing = this->bindings.contains(name);
+    std::vector<std::string> const order =
+        existing ? this->downstream(name) : std::vector{name};
+
+    for (std::string const &affected : order)
+        if (dependencies.contains(affected))
+            throw std::runtime_error{"Cyclic definition!"};
+
+    std::map<std::string, Binding> saved;
+
+    for (std::string const &affected : order)
+        if (existing)
+            saved.emplace(affected, *this->bindings.at(affected));
+
+    std::set<std::string> const previous =
+        existing ? saved.at(name).dependencies : std::set<std::string>{};
+
+    try {
+        auto &entry = this->bindings[name];
+
+        if (!entry)
+            entry = std::make_unique<Binding>();
+
+        binding.dependencies = std::move(entry->dependencies);
+        binding.dependents = std::move(entry->dependents);
+        *entry = std::move(binding);
+        this->link(name, std::move(dependencies));
+
+        for (std::string const &affected : order)
+            this->recompute(affected);
+    } catch (...) {
+        this->link(name, previous);
+
+        for (auto &[affected, binding] : saved) {
+            this->scope.define(affected, binding.parameters, binding.value);
+            *this->bindings.at(affected) = std::move(binding);
+        }
+
+        if (!existing) {
+            this->bindings.erase(name);
+            this->scope.undef(name);
+        }
+
+        throw;
+    }
+
+    return order;
+}
+
+std::vector<std::string> mlp::Workspace::bind(std::string const &definition) {
+    Binding binding;
+    std::string name;
+
+    {
+        Context::Scope const scope{this->scope};
+
+        std::tie(name, binding.parameters, binding.body) =
+            parse_definition(definition);
+    }
+
+    binding.source = definition.substr(definition.find('=') + 1);
+
+    std::set<std::string> dependencies;
+    this->collect(std::string_view{binding.source}, dependencies);
+
+    return this->update(name, std::move(binding), std::move(dependencies));
+}
+
+std::vector<std::string> mlp::Workspace::bind(
+    std::string const &name, std::vector<Variable> parameters, Token body
+) {
+    std::set<std::string> dependencies;
+    this->collect(body, dependencies);
+
+    Binding binding;
+    binding.parameters = std::move(parameters);
+    binding.body = std::move(body);
+
+    return this->update(name, std::move(binding), std::move(dependencies));
+}
+
+void mlp::Workspace::erase(std::string const &name) {
+    if (!this->bindings.at(name)->dependents.empty())
+        throw std::runtime_error{"Binding is still referenced!"};
+
+    this->link(name, {});
+    this->bindings.erase(name);
+    this->scope.undef(name);
+}
+
+bool mlp::Workspace::contains(std::string const &name) const {
+    return this->bindings.contains(name);
+}
+
+std::vector<std::string> mlp::Workspace::names() const {
+    std::vector<std::string> names;
+    names.reserve(this->bindings.size());
+
+    for (auto const &[name, binding] : this->bindings)
+        names.push_back(name);
+
+    return names;
+}
+
+std::vector<mlp::Variable> const &
+mlp::Workspace::parameters(std::string const &name) const {
+    return this->bindings.at(name)->parameters;
+}
+
+mlp::Token const &mlp::Workspace::value(std::string const &name) const {
+    return this->bindings.at(name)->value;
+}
+
+std::optional<mlp::ProgramView>
+mlp::Workspace::program(std::string const &name) const {
+    auto const &program = this->bindings.at(name)->program;
+
+    if (!program)
+        return std::nullopt;
+
+    return *program;
+}
+
+mlp::Token mlp::Workspace::tokenise(std::string const &expression) {
+    Context::Scope const scope{this->scope};
+
+    return mlp::tokenise(expression);
+}
+
+mlp::Token mlp::Workspace::resolved(Token const &token) {
+    Context::Scope const scope{this->scope};
+
+    return simplified(token);
+}
+
+mlp::Context &mlp::Workspace::context() { return this->scope; }
@@ -1,10 +1,18 @@
+#include "include/context.h"
 #include "include/expression.h"
 #include "include/function.h"
+#include "include/library.h"
+#include "include/server.h"
 #include "include/term.h"
 #include "include/terms.h"
 #include "include/token.h"
+#include "include/trace.h"
 #include "include/variable.h"
+#include "include/workspace.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <ranges>
 #include <sstream>
@@ -54,12 +62,114 @@ std::map<Variable, Token> get_values() {
     return values;
 }
 
+std::int32_t build_library(char const *input, char const *output) {
+    std::ifstream file{input};
+
+    if (!file)
+        throw std::runtime_error{"Cannot open expression list!"};
+
+    std::map<std::string, Token> expressions;
+
+    for (std::string line; std::getline(file, line);) {
+        std::size_t const separator = line.find('=');
+
+        if (separator == std::string::npos)
+            continue;
+
+        expressions[line.substr(0, separator)] =
+            tokenise(line.substr(separator + 1));
+    }
+
+    Library::write(output, expressions);
+
+    std::cout << "Wrote " << expressions.size() << " expressions to "
+              << output << '\n';
+
+    return 0;
+}
+
+// Reads "f(x) = body" definitions and expressions line by line, first from
+// the optional file and then from standard input. Definitions print every
+// binding they recomputed; expressions print their resolved value.
+std::int32_t run_workspace(char const *path) {
+    Workspace workspace;
+
+    auto const process = [&workspace](std::string const &line) {
+        if (line.find_first_not_of(' ') == std::string::npos)
+            return;
+
+        try {
+            if (line.find('=') == std::string::npos) {
+                std::cout << workspace.resolved(workspace.tokenise(line))
+                          << '\n';
+
+                return;
+            }
+
+            for (std::string const &name : workspace.bind(line)) {
+                auto const &parameters = workspace.parameters(name);
+
+                std::cout << name << '(';
+
+                for (std::size_t i = 0; i < parameters.size(); ++i)
+                    std::cout << (i ? ", " : "") << Token{parameters[i]};
+
+                std::cout << ") = " << workspace.value(name) << '\n';
+            }
+        } catch (std::exception const &error) {
+            std::cerr << error.what() << '\n';
+        }
+    };
+
+    if (path) {
+        std::ifstream file{path};
+
+        if (!file)
+            throw std::runtime_error{"Cannot open workspace!"};
+
+        for (std::string line; std::getline(file, line);)
+            process(line);
+    }
+
+    for (std::string line; std::getline(std::cin, line);)
+        process(line);
+
+    return 0;
+}
+
 std::int32_t main(std::int32_t argc, char *argv[]) {
+    if (char const *path = std::getenv("MLP_TRACE"))
+        trace::start(path);
+
+    if (char const *threshold = std::getenv("MLP_PARALLEL"))
+        Context::global().parallelise(std::strtoull(threshold, nullptr, 10));
+
+    if (argc == 4 && std::string_view{argv[1]} == "--build-library")
+        return build_library(argv[2], argv[3]);
+
+    if (argc == 3 && std::string_view{argv[1]} == "--server") {
+        Server{argv[2]}.serve();
+
+        return 0;
+    }
+
+    if (argc >= 2 && argc <= 3 && std::string_view{argv[1]} == "--workspace")
+        return run_workspace(argc == 3 ? argv[2] : nullptr);
+
+    std::optional<Library> library;
+
+    if (argc == 3 && std::string_view{argv[1]} == "--library")
+        library.emplace(argv[2]);
+
     std::cout << "Enter expression: ";
 
-    Token input;
+    std::string expression;
+    std::cin >> expression;
 
-    std::cin >> input;
+    bool const preloaded = library && library->contains(expression);
+
+    Token const input =
+        preloaded ? library->token(expression) : tokenise(expression);
 
     std::int32_t choice = get_choice(
         {"Simplify", "Differentiate", "Integrate (incomplete)", "Evaluate"}
@@ -113,6 +223,30 @@ std::int32_t main(std::int32_t argc, char *argv[]) {
     } else if (choice == 4) {
         std::map<Variable, Token> const values = get_values();
 
+        // The compiled program needs a number for every input; anything less
+        // is left to the symbolic evaluator, which keeps the rest as is.
+        auto const numeric = [&values](char const input) -> bool {
+            auto const value = values.find(Variable{input});
+
+            return value != values.end() &&
+                   std::holds_alternative<Constant>(value->second);
+        };
+
+        if (auto const program =
+                preloaded ? library->program(expression) : std::nullopt;
+            program && std::ranges::all_of(program->inputs, numeric)) {
+            std::map<Variable, Constant> constants;
+
+            for (auto const &[variable, value] : values)
+                if (auto const *constant = std::get_if<Constant>(&value))
+                    constants[variable] = *constant;
+
+            std::cout << input << " evaluated under given conditions is "
+                      << Token{evaluate(*program, constants)} << '\n';
+
+            return 0;
+        }
+
         std::cout << input << " evaluated under given conditions is "
                   << evaluate(input, values) << '\n';
     }